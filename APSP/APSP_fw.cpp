@@ -1,7 +1,8 @@
 #include <cassert>
-#include <fstream>
 #include <iostream>
 #include <vector>
+
+#include "../Graph/GraphLoader.h"
 using namespace std;
 
 const int INF = 2e8;
@@ -28,17 +29,20 @@ void floyd_warshall() {
 }
 
 int main() {
-    ifstream in;
-    in.open("input.txt");
+    EdgeList<int> input;
+    if (!loadEdgeList("input.txt", input)) {
+        cerr << "Could not read input.txt\n";
+        return 1;
+    }
 
-    in >> n >> m;
+    n = input.n;
+    m = input.edges.size();
     adj_mat.assign(n + 2, vector<int>(n + 2, INF));
     distfw.assign(n + 2, vector<int>(n + 2, INF));
     parent.assign(n + 2, vector<int>(n + 2, -1));
 
     for (int i = 0; i < m; i++) {
-        int u, v, w;
-        in >> u >> v >> w;
+        int u = input.edges[i].from, v = input.edges[i].to, w = input.edges[i].weight;
         adj_mat[u][v] = min(adj_mat[u][v], w);
         parent[u][v] = u;
     }
@@ -67,6 +71,5 @@ int main() {
         cout << "\n";
     }
 
-    in.close();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+#include <cassert>
+#include <climits>
+#include <vector>
+using namespace std;
+
+// compressed sparse row graph, shared by the SSSP, MST and Heap drivers
+// the out-edges of u are targets[i], weights[i] for i in
+// [offsets[u], offsets[u + 1]), so scanning them is a sequential read of two
+// arrays instead of a pointer chase into one vector per vertex
+template <typename W>
+struct WeightedEdge {
+    int from, to;
+    W weight;
+};
+
+template <typename W>
+struct CSRGraph {
+    int n = 0;
+    vector<int> offsets;  // n + 1 entries
+    vector<int> targets;
+    vector<W> weights;
+
+    int edgeCount() const { return targets.size(); }
+    int degree(int u) const { return offsets[u + 1] - offsets[u]; }
+};
+
+// counting sort of the edges by source: count the out-degrees, prefix sum
+// them into offsets, then drop every edge into its slot
+// every vertex keeps its edges in input order, so results and tie breaks
+// match the old adjacency lists exactly
+// undirected adds v -> u right after u -> v, like pushing into both lists
+template <typename W>
+CSRGraph<W> buildCSR(int n, const vector<WeightedEdge<W>>& edges, bool undirected = false) {
+    assert(edges.size() * (undirected ? 2 : 1) < INT_MAX);
+    CSRGraph<W> g;
+    g.n = n;
+    g.offsets.assign(n + 2, 0);
+    for (const auto& e : edges) {
+        assert(e.from >= 0 && e.from < n && e.to >= 0 && e.to < n);
+        g.offsets[e.from + 2]++;
+        if (undirected) g.offsets[e.to + 2]++;
+    }
+    // offsets[u + 2] held the degree of u; after the prefix sum offsets[u + 1]
+    // is where u's edges start, and it is pushed forward while filling
+    for (int u = 2; u <= n + 1; u++) g.offsets[u] += g.offsets[u - 1];
+    int total = g.offsets[n + 1];
+    g.targets.resize(total);
+    g.weights.resize(total);
+    for (const auto& e : edges) {
+        int i = g.offsets[e.from + 1]++;
+        g.targets[i] = e.to;
+        g.weights[i] = e.weight;
+        if (undirected) {
+            i = g.offsets[e.to + 1]++;
+            g.targets[i] = e.from;
+            g.weights[i] = e.weight;
+        }
+    }
+    g.offsets.pop_back();
+    return g;
+}
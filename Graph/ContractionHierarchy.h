@@ -0,0 +1,256 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "GraphLoader.h"
+using namespace std;
+
+// contraction hierarchy of an undirected graph (Geisberger et al.)
+// vertices are contracted one by one, least important first; taking v out
+// adds a shortcut u - x for every pair of its remaining neighbours whose
+// shortest connection runs through v, unless a witness search from u that
+// avoids v finds a path at most as short
+// importance = shortcuts it would add - edges it removes + neighbours already
+// contracted; the queue is lazy: a popped vertex is evaluated again and goes
+// back in if it is no longer the least important
+// what is kept are the edges from every vertex to higher ranked ones
+// (original or shortcut): a shortest path can always be made to go up in rank
+// and then down, so an s-t query is an upward search from s and one from t
+// this pays off on road-like graphs; on random graphs the last vertices to go
+// end up nearly fully connected and the contraction gets very slow
+const char CH_MAGIC[8] = {'C', 'H', 'I', 'E', 'R', '0', '1', '\0'};
+
+template <typename W>
+struct ContractionHierarchy {
+    vector<int> rank;  // position in the contraction order
+    CSRGraph<W> up;    // edges to higher ranked vertices
+    vector<int> hops;  // original edges behind each edge of up
+};
+
+struct CHFileHeader {
+    char magic[8];
+    int32_t weightSize;
+    int64_t n, m;
+    int64_t sourceSize;  // size of the text the graph came from
+};
+// then int32 rank[n], int32 offsets[n + 1], int32 targets[m], W weights[m],
+// int32 hops[m]
+
+template <typename W>
+class Contractor {
+   private:
+    struct Arc {
+        int to;
+        W weight;
+        int hops;
+    };
+
+    // a witness search gives up after settling this many vertices; a missed
+    // witness only costs an unneeded shortcut
+    static const int WITNESS_SETTLE = 500;
+
+    int n;
+    vector<vector<Arc>> adj;  // between vertices not contracted yet
+    vector<int> deleted;      // contracted neighbours per vertex
+    vector<W> dist;           // witness search, INF outside touched
+    vector<int> touched;
+    vector<int> target;  // == stamp for the vertices a witness search looks for
+    int stamp = 0;
+    W INF = numeric_limits<W>::max() / 4;
+
+    // dist from u to the targets (marked with stamp), never passing through
+    // skip; stops once they are all settled or the rest is beyond limit
+    void witness(int u, int skip, W limit, int targets) {
+        for (int x : touched) dist[x] = INF;
+        touched.clear();
+        priority_queue<pair<W, int>, vector<pair<W, int>>, greater<pair<W, int>>> pq;
+        dist[u] = 0;
+        touched.push_back(u);
+        pq.push({0, u});
+        int settled = 0;
+        while (!pq.empty() && settled < WITNESS_SETTLE && targets > 0) {
+            auto [d, x] = pq.top();
+            pq.pop();
+            if (d > dist[x]) continue;
+            if (d > limit) break;
+            settled++;
+            if (target[x] == stamp) targets--;
+            for (const Arc& a : adj[x]) {
+                if (a.to == skip || d + a.weight >= dist[a.to]) continue;
+                if (dist[a.to] == INF) touched.push_back(a.to);
+                dist[a.to] = d + a.weight;
+                pq.push({dist[a.to], a.to});
+            }
+        }
+    }
+
+    // the shortcuts taking v out would need, as (from, arc) pairs
+    void shortcuts(int v, vector<pair<int, Arc>>& out) {
+        out.clear();
+        const vector<Arc>& nb = adj[v];
+        for (int i = 0; i + 1 < (int)nb.size(); i++) {
+            // the pairs (i, j > i): a witness must be found for each nb[j]
+            stamp++;
+            W maxWeight = 0;
+            for (int j = i + 1; j < (int)nb.size(); j++) {
+                target[nb[j].to] = stamp;
+                maxWeight = max(maxWeight, nb[j].weight);
+            }
+            witness(nb[i].to, v, nb[i].weight + maxWeight, nb.size() - i - 1);
+            for (int j = i + 1; j < (int)nb.size(); j++) {
+                W via = nb[i].weight + nb[j].weight;
+                if (dist[nb[j].to] > via)
+                    out.push_back({nb[i].to, {nb[j].to, via, nb[i].hops + nb[j].hops}});
+            }
+        }
+    }
+
+    // a -> b, or a shorter weight for an arc that is there already
+    void addArc(int a, const Arc& arc) {
+        for (Arc& x : adj[a]) {
+            if (x.to == arc.to) {
+                if (arc.weight < x.weight) x = arc;
+                return;
+            }
+        }
+        adj[a].push_back(arc);
+    }
+
+    void removeArc(int a, int b) {
+        for (int i = 0; i < (int)adj[a].size(); i++) {
+            if (adj[a][i].to == b) {
+                adj[a][i] = adj[a].back();
+                adj[a].pop_back();
+                return;
+            }
+        }
+    }
+
+    int importance(int v, vector<pair<int, Arc>>& scratch) {
+        shortcuts(v, scratch);
+        return (int)scratch.size() - (int)adj[v].size() + deleted[v];
+    }
+
+   public:
+    Contractor(const CSRGraph<W>& g) : n(g.n), adj(g.n), deleted(g.n, 0) {
+        dist.assign(n, INF);
+        target.assign(n, 0);
+        // parallel edges collapse to the lightest, self loops never help
+        for (int u = 0; u < n; u++) {
+            for (int i = g.offsets[u]; i < g.offsets[u + 1]; i++) {
+                int v = g.targets[i];
+                if (v != u) {
+                    addArc(u, {v, g.weights[i], 1});
+                    addArc(v, {u, g.weights[i], 1});
+                }
+            }
+        }
+    }
+
+    ContractionHierarchy<W> run() {
+        ContractionHierarchy<W> ch;
+        ch.rank.assign(n, -1);
+        vector<WeightedEdge<W>> upEdges;
+        vector<WeightedEdge<int>> upHops;
+        vector<pair<int, Arc>> added;
+
+        priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> order;
+        for (int v = 0; v < n; v++) order.push({importance(v, added), v});
+        int next = 0;
+        while (!order.empty()) {
+            int v = order.top().second;
+            order.pop();
+            int p = importance(v, added);  // also leaves its shortcuts in added
+            if (!order.empty() && p > order.top().first) {
+                order.push({p, v});
+                continue;
+            }
+            ch.rank[v] = next++;
+            for (auto& [from, arc] : added) {
+                addArc(from, arc);
+                addArc(arc.to, {from, arc.weight, arc.hops});
+            }
+            // everything still around is ranked higher than v
+            for (const Arc& a : adj[v]) {
+                upEdges.push_back({v, a.to, a.weight});
+                upHops.push_back({v, a.to, a.hops});
+                removeArc(a.to, v);
+                deleted[a.to]++;
+            }
+            adj[v].clear();
+            adj[v].shrink_to_fit();
+        }
+        // both are stable counting sorts of the same edges, so hops lines up
+        ch.up = buildCSR(n, upEdges);
+        ch.hops = buildCSR(n, upHops).weights;
+        return ch;
+    }
+};
+
+template <typename W>
+ContractionHierarchy<W> contractGraph(const CSRGraph<W>& g) {
+    return Contractor<W>(g).run();
+}
+
+template <typename W>
+bool saveHierarchy(const string& path, const ContractionHierarchy<W>& ch, long long sourceSize = 0) {
+    CHFileHeader h;
+    memcpy(h.magic, CH_MAGIC, 8);
+    h.weightSize = sizeof(W);
+    h.n = ch.up.n;
+    h.m = ch.up.edgeCount();
+    h.sourceSize = sourceSize;
+    ofstream out(path, ios::binary | ios::trunc);
+    out.write((const char*)&h, sizeof(h));
+    out.write((const char*)ch.rank.data(), h.n * sizeof(int));
+    out.write((const char*)ch.up.offsets.data(), (h.n + 1) * sizeof(int));
+    out.write((const char*)ch.up.targets.data(), h.m * sizeof(int));
+    out.write((const char*)ch.up.weights.data(), h.m * sizeof(W));
+    out.write((const char*)ch.hops.data(), h.m * sizeof(int));
+    return (bool)out;
+}
+
+// sourceSize -1 accepts a hierarchy of any text
+template <typename W>
+bool loadHierarchy(const string& path, ContractionHierarchy<W>& ch, long long sourceSize = -1) {
+    ifstream in(path, ios::binary);
+    CHFileHeader h;
+    if (!in.read((char*)&h, sizeof(h))) return false;
+    if (memcmp(h.magic, CH_MAGIC, 8) != 0 || h.weightSize != sizeof(W) ||
+        (sourceSize != -1 && h.sourceSize != sourceSize))
+        return false;
+    ch.rank.resize(h.n);
+    ch.up.n = h.n;
+    ch.up.offsets.resize(h.n + 1);
+    ch.up.targets.resize(h.m);
+    ch.up.weights.resize(h.m);
+    ch.hops.resize(h.m);
+    in.read((char*)ch.rank.data(), h.n * sizeof(int));
+    in.read((char*)ch.up.offsets.data(), (h.n + 1) * sizeof(int));
+    in.read((char*)ch.up.targets.data(), h.m * sizeof(int));
+    in.read((char*)ch.up.weights.data(), h.m * sizeof(W));
+    in.read((char*)ch.hops.data(), h.m * sizeof(int));
+    return (bool)in;
+}
+
+// the hierarchy of the graph read from textPath, from textPath + ".ch" while
+// that is fresh; otherwise (or with rebuild) it is contracted and saved
+template <typename W>
+ContractionHierarchy<W> hierarchyFor(const string& textPath, const CSRGraph<W>& g,
+                                     bool rebuild = false) {
+    string path = textPath + ".ch";
+    struct stat text;
+    long long size = stat(textPath.c_str(), &text) == 0 ? text.st_size : 0;
+    ContractionHierarchy<W> ch;
+    if (!rebuild && size && isFresh(path, text) && loadHierarchy(path, ch, size) && ch.up.n == g.n)
+        return ch;
+    ch = contractGraph(g);
+    saveHierarchy(path, ch, size);
+    return ch;
+}
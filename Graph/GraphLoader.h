@@ -0,0 +1,261 @@
+#pragma once
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "CSRGraph.h"
+using namespace std;
+
+// graph input shared by the drivers
+// text: "n m", then m edges "u v w", then whatever numbers the driver wants
+// after them (the tail, e.g. "s d"); any whitespace separates numbers
+// the text is mmap'ed and split into one chunk per thread: every thread
+// counts the numbers in its chunk, a prefix sum tells it which edge field its
+// first number is, and then it parses its chunk straight into the edge list
+// a binary copy (path + ".bin") is written after the first parse and read
+// instead of the text while it is newer than the text
+const char EDGE_MAGIC[8] = {'G', 'E', 'D', 'G', 'E', '0', '1', '\0'};
+
+template <typename W>
+struct EdgeList {
+    int n = 0;
+    vector<WeightedEdge<W>> edges;
+    vector<long long> tail;
+};
+
+struct EdgeFileHeader {
+    char magic[8];
+    int32_t weightSize, weightFloating;
+    int64_t n, m, tailCount;
+    int64_t sourceSize;  // size of the text it was made from
+};
+// then int32 from[m], int32 to[m], W weight[m], int64 tail[tailCount]
+
+inline bool isSpace(char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+inline long long scanInt(const char*& p) {
+    bool neg = *p == '-';
+    if (*p == '-' || *p == '+') p++;
+    long long x = 0;
+    while (*p >= '0' && *p <= '9') x = x * 10 + (*p++ - '0');
+    return neg ? -x : x;
+}
+
+// exact when the digits fit a double and the power of ten does too (the
+// usual "1.39" kind of weight); anything else goes through strtod
+inline double scanDouble(const char*& p, const char* end) {
+    static const double pow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                   1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                   1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    const char* start = p;
+    bool neg = *p == '-';
+    if (*p == '-' || *p == '+') p++;
+    uint64_t mant = 0;
+    int digits = 0, scale = 0;
+    for (; *p >= '0' && *p <= '9'; p++, digits++) mant = mant * 10 + (*p - '0');
+    if (*p == '.') {
+        for (p++; *p >= '0' && *p <= '9'; p++, digits++, scale++) mant = mant * 10 + (*p - '0');
+    }
+    if (*p == 'e' || *p == 'E' || digits > 15 || scale > 22) {
+        char buf[64];
+        const char* q = start;
+        while (q < end && !isSpace(*q)) q++;
+        int len = min<long>(q - start, sizeof(buf) - 1);
+        memcpy(buf, start, len);
+        buf[len] = '\0';
+        p = q;
+        return strtod(buf, nullptr);
+    }
+    double x = mant / pow10[scale];
+    return neg ? -x : x;
+}
+
+template <typename W>
+W scanWeight(const char*& p, const char* end) {
+    if (is_floating_point<W>::value) return scanDouble(p, end);
+    else return scanInt(p);
+}
+
+// sourceSize -1 accepts a copy of any text
+template <typename W>
+bool loadEdgeBinary(const string& path, EdgeList<W>& out, long long sourceSize = -1) {
+    ifstream in(path, ios::binary);
+    EdgeFileHeader h;
+    if (!in.read((char*)&h, sizeof(h))) return false;
+    if (memcmp(h.magic, EDGE_MAGIC, 8) != 0 || h.weightSize != sizeof(W) ||
+        h.weightFloating != is_floating_point<W>::value ||
+        (sourceSize != -1 && h.sourceSize != sourceSize))
+        return false;
+    vector<int32_t> from(h.m), to(h.m);
+    vector<W> weight(h.m);
+    out.tail.resize(h.tailCount);
+    in.read((char*)from.data(), h.m * sizeof(int32_t));
+    in.read((char*)to.data(), h.m * sizeof(int32_t));
+    in.read((char*)weight.data(), h.m * sizeof(W));
+    in.read((char*)out.tail.data(), h.tailCount * sizeof(long long));
+    if (!in) return false;
+    out.n = h.n;
+    out.edges.resize(h.m);
+    for (int64_t i = 0; i < h.m; i++) out.edges[i] = {from[i], to[i], weight[i]};
+    return true;
+}
+
+template <typename W>
+bool saveEdgeBinary(const string& path, const EdgeList<W>& list, long long sourceSize = 0) {
+    EdgeFileHeader h;
+    memcpy(h.magic, EDGE_MAGIC, 8);
+    h.weightSize = sizeof(W);
+    h.weightFloating = is_floating_point<W>::value;
+    h.n = list.n;
+    h.m = list.edges.size();
+    h.tailCount = list.tail.size();
+    h.sourceSize = sourceSize;
+    vector<int32_t> from(h.m), to(h.m);
+    vector<W> weight(h.m);
+    for (int64_t i = 0; i < h.m; i++) {
+        from[i] = list.edges[i].from;
+        to[i] = list.edges[i].to;
+        weight[i] = list.edges[i].weight;
+    }
+    ofstream out(path, ios::binary | ios::trunc);
+    out.write((const char*)&h, sizeof(h));
+    out.write((const char*)from.data(), h.m * sizeof(int32_t));
+    out.write((const char*)to.data(), h.m * sizeof(int32_t));
+    out.write((const char*)weight.data(), h.m * sizeof(W));
+    out.write((const char*)list.tail.data(), h.tailCount * sizeof(long long));
+    return (bool)out;
+}
+
+template <typename W>
+bool parseEdgeText(const char* text, size_t size, EdgeList<W>& out, int threads) {
+    const char* end = text + size;
+    // the header, serially: it sizes everything else
+    const char* p = text;
+    while (p < end && isSpace(*p)) p++;
+    if (p == end) return false;
+    out.n = scanInt(p);
+    while (p < end && isSpace(*p)) p++;
+    if (p == end) return false;
+    long long m = scanInt(p);
+    out.edges.resize(m);
+
+    // chunk boundaries, moved forward to the next whitespace so no number is cut
+    vector<const char*> bound(threads + 1);
+    bound[0] = p;
+    bound[threads] = end;
+    for (int t = 1; t < threads; t++) {
+        const char* q = p + (end - p) * t / threads;
+        while (q < end && !isSpace(*q)) q++;
+        bound[t] = max(q, bound[t - 1]);
+    }
+
+    auto run = [&](auto f) {
+        vector<thread> workers;
+        for (int t = 1; t < threads; t++) workers.emplace_back(f, t);
+        f(0);
+        for (auto& w : workers) w.join();
+    };
+
+    vector<long long> count(threads + 1, 0);
+    run([&](int t) {
+        // a number starts wherever whitespace is followed by something else
+        long long c = 0;
+        bool prevSpace = true;  // every chunk starts right after a number or on whitespace
+        for (const char* q = bound[t]; q < bound[t + 1]; q++) {
+            bool space = isSpace(*q);
+            c += prevSpace && !space;
+            prevSpace = space;
+        }
+        count[t + 1] = c;
+    });
+    for (int t = 1; t <= threads; t++) count[t] += count[t - 1];
+    if (count[threads] < 3 * m) return false;
+    out.tail.resize(count[threads] - 3 * m);
+
+    // number g of the body is field g % 3 of edge g / 3, or tail[g - 3m]
+    run([&](int t) {
+        long long g = count[t], e = g / 3;
+        int field = g % 3;
+        WeightedEdge<W>* edges = out.edges.data();
+        const char* q = bound[t];
+        const char* stop = bound[t + 1];
+        while (true) {
+            while (q < stop && isSpace(*q)) q++;
+            if (q == stop) break;
+            if (e >= m) out.tail[g - 3 * m] = scanInt(q);
+            else if (field == 0) edges[e].from = scanInt(q);
+            else if (field == 1) edges[e].to = scanInt(q);
+            else edges[e].weight = scanWeight<W>(q, end);
+            while (q < stop && !isSpace(*q)) q++;  // junk after a number
+            g++;
+            if (++field == 3) {
+                field = 0;
+                e++;
+            }
+        }
+    });
+    return true;
+}
+
+inline int loaderThreads() { return max(1u, thread::hardware_concurrency()); }
+
+template <typename W>
+bool parseEdgeFile(const string& path, EdgeList<W>& out, int threads = loaderThreads()) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    // one byte more than the file, so the scanners always stop on a '\0'
+    size_t length = st.st_size + 1;
+    void* base = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    bool ok = false;
+    if (base != MAP_FAILED) {
+        // past the end of the file, but still inside the last page?
+        if (st.st_size % sysconf(_SC_PAGESIZE) != 0) {
+            ok = parseEdgeText((const char*)base, st.st_size, out, threads);
+        } else {
+            // the file fills its last page, so that extra byte isn't mapped; copy
+            string text((const char*)base, st.st_size);
+            ok = parseEdgeText(text.c_str(), text.size(), out, threads);
+        }
+        munmap(base, length);
+    }
+    close(fd);
+    return ok;
+}
+
+// whether the derived file (a cache made from text) exists and is at least as
+// new as text
+inline bool isFresh(const string& path, const struct stat& text) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 &&
+           (st.st_mtim.tv_sec > text.st_mtim.tv_sec ||
+            (st.st_mtim.tv_sec == text.st_mtim.tv_sec && st.st_mtim.tv_nsec >= text.st_mtim.tv_nsec));
+}
+
+// the loader the drivers use: the binary copy if it is fresh, else the text
+// (and then the binary copy is refreshed for the next run)
+template <typename W>
+bool loadEdgeList(const string& path, EdgeList<W>& out) {
+    string binPath = path + ".bin";
+    struct stat text;
+    if (stat(path.c_str(), &text) != 0) return false;
+    if (isFresh(binPath, text) && loadEdgeBinary(binPath, out, text.st_size)) return true;
+    out = EdgeList<W>();
+    if (!parseEdgeFile(path, out)) return false;
+    saveEdgeBinary(binPath, out, text.st_size);  // only a cache, a failure here is fine
+    return true;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+
+#include "hashing.h"
+
+// thread safe map with the same surface as SeparateChaining
+// keys are split over a power of two number of shards, each one a
+// SeparateChaining table behind its own reader-writer lock, so threads only
+// contend when they hit the same shard, and readers never wait for each other
+struct alignas(64) Shard {  // one cache line each, no false sharing of locks
+    shared_mutex lock;
+    SeparateChaining* table;
+};
+
+class ShardedHashMap {
+   private:
+    int shardBits;
+    Shard* shards;
+
+    Shard& shardOf(const string& s) {
+        // the tables use primaryHash % m, so take the shard from the top bits
+        // of a scrambled copy instead of reusing the same low bits
+        unsigned long long h = primaryHash(s, MOD) * 0x9E3779B97F4A7C15ull;
+        return shards[shardBits == 0 ? 0 : h >> (64 - shardBits)];
+    }
+
+   public:
+    // m is the total capacity, spread evenly over the shards
+    ShardedHashMap(int m, int shardCount = 64) {
+        shardBits = 0;
+        while ((1 << shardBits) < shardCount) shardBits++;
+        shards = new Shard[1 << shardBits];
+        int perShard = nextPrimeNumber(m / (1 << shardBits) + 1);
+        for (int i = 0; i < (1 << shardBits); i++) shards[i].table = new SeparateChaining(perShard);
+    }
+
+    ~ShardedHashMap() {
+        for (int i = 0; i < (1 << shardBits); i++) delete shards[i].table;
+        delete[] shards;
+    }
+
+    int getShardCount() { return 1 << shardBits; }
+
+    int getSize() {
+        int size = 0;
+        for (int i = 0; i < (1 << shardBits); i++) {
+            shared_lock<shared_mutex> guard(shards[i].lock);
+            size += shards[i].table->getSize();
+        }
+        return size;
+    }
+
+    bool search(const string& s) {
+        Shard& sh = shardOf(s);
+        shared_lock<shared_mutex> guard(sh.lock);
+        return sh.table->search(s);
+    }
+
+    int getValue(const string& s) {
+        Shard& sh = shardOf(s);
+        shared_lock<shared_mutex> guard(sh.lock);
+        return sh.table->getValue(s);
+    }
+
+    void insert(const string& s, int val) {
+        Shard& sh = shardOf(s);
+        unique_lock<shared_mutex> guard(sh.lock);
+        sh.table->insert(s, val);
+    }
+
+    void remove(const string& s) {
+        Shard& sh = shardOf(s);
+        unique_lock<shared_mutex> guard(sh.lock);
+        sh.table->remove(s);
+    }
+};
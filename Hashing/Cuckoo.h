@@ -0,0 +1,239 @@
+#pragma once
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "hashing.h"
+
+// bucketized cuckoo hashing
+// every key has exactly two candidate buckets of 4 slots, one from primaryHash
+// and one from hash2, so a lookup reads at most two buckets (plus the stash,
+// which is empty almost always)
+// an insert that finds both buckets full searches, breadth first, for the
+// shortest chain of keys that can each move to their other bucket, then
+// shifts that chain by one; if there is none, the key goes to the stash, and
+// once the stash is full the table doubles its buckets and places every key again
+const int BUCKET_WIDTH = 4;
+const int MAX_BFS_NODES = 512;  // about 4 levels of the 4-ary search tree
+const int STASH_SIZE = 8;
+
+template <typename K>
+class BasicCuckooHashing {
+   private:
+    typedef BasicPair2<K> Pair2;
+    struct BfsNode {
+        int bucket;
+        int parent;  // index in the bfs queue, -1 for the two start buckets
+        int slot;    // slot in the parent's bucket whose key moves here
+    };
+
+    int m, size = 0, buckets;
+    Pair2* hashTable;  // bucket b is hashTable[b * BUCKET_WIDTH ...]
+    vector<Pair2> stash;
+    vector<BfsNode> bfs;  // reused between inserts
+
+    void candidates(const K& s, int& b1, int& b2) {
+        b1 = keyHash(s) % buckets;
+        b2 = keyHash2(s, MOD) % buckets;
+        if (b2 == b1) b2 = (b1 + 1) % buckets;  // always two different buckets
+    }
+
+    int otherBucket(const K& s, int b) {
+        int b1, b2;
+        candidates(s, b1, b2);
+        return b == b1 ? b2 : b1;
+    }
+
+    int findInBucket(int b, const K& s) {
+        for (int k = 0; k < BUCKET_WIDTH; k++) {
+            int idx = b * BUCKET_WIDTH + k;
+            if (hashTable[idx].value != -1 && hashTable[idx].key == s) return idx;
+        }
+        return -1;
+    }
+
+    int freeSlot(int b) {
+        for (int k = 0; k < BUCKET_WIDTH; k++) {
+            if (hashTable[b * BUCKET_WIDTH + k].value == -1) return b * BUCKET_WIDTH + k;
+        }
+        return -1;
+    }
+
+    int search_help(const K& s, int& probe, int& stashIdx) {
+        // returns the found index in hashTable, else -1
+        // stashIdx is set if the key is in the stash instead
+        int b1, b2;
+        candidates(s, b1, b2);
+        stashIdx = -1;
+        probe = 0;
+        int ret = findInBucket(b1, s);
+        if (ret != -1) return ret;
+        probe = 1;
+        ret = findInBucket(b2, s);
+        if (ret != -1 || stash.empty()) return ret;
+        probe = 2;
+        for (int i = 0; i < (int)stash.size(); i++) {
+            if (stash[i].key == s) stashIdx = i;
+        }
+        return -1;
+    }
+
+    // a chain that visits a bucket twice would move a slot twice,
+    // and the second time it no longer holds the key it was chosen for
+    bool onPath(int node, int bucket) {
+        for (; node != -1; node = bfs[node].parent) {
+            if (bfs[node].bucket == bucket) return true;
+        }
+        return false;
+    }
+
+    // shortest chain of displacements that frees a slot in b1 or b2
+    // returns the freed slot, or -1 if none within MAX_BFS_NODES
+    int cuckooPath(int b1, int b2) {
+        bfs.clear();
+        bfs.push_back({b1, -1, -1});
+        bfs.push_back({b2, -1, -1});
+        for (int head = 0; head < (int)bfs.size(); head++) {
+            BfsNode cur = bfs[head];
+            int free = freeSlot(cur.bucket);
+            if (free != -1) {
+                // walk back to the start, moving every key one step down the chain
+                while (cur.parent != -1) {
+                    const BfsNode& par = bfs[cur.parent];
+                    int from = par.bucket * BUCKET_WIDTH + cur.slot;
+                    hashTable[free] = move(hashTable[from]);
+                    hashTable[from].key = K();
+                    hashTable[from].value = -1;
+                    free = from;
+                    cur = par;
+                }
+                return free;
+            }
+            if (bfs.size() >= MAX_BFS_NODES) continue;
+            for (int k = 0; k < BUCKET_WIDTH; k++) {
+                const K& key = hashTable[cur.bucket * BUCKET_WIDTH + k].key;
+                int alt = otherBucket(key, cur.bucket);
+                if (!onPath(head, alt)) bfs.push_back({alt, head, k});
+            }
+        }
+        return -1;
+    }
+
+    // puts a key that is not in the table into one of its buckets or the stash
+    // returns false (leaving p untouched) if both are full
+    bool place(Pair2&& p) {
+        int b1, b2;
+        candidates(p.key, b1, b2);
+        int j = freeSlot(b1);
+        if (j == -1) j = freeSlot(b2);
+        if (j == -1) j = cuckooPath(b1, b2);
+        if (j != -1) hashTable[j] = move(p);
+        else if ((int)stash.size() < STASH_SIZE) stash.push_back(move(p));
+        else return false;
+        return true;
+    }
+
+    // moves every key out of the table and the stash, and frees the table
+    void takeAll(vector<Pair2>& out) {
+        for (int i = 0; i < m; i++) {
+            if (hashTable[i].value != -1) out.push_back(move(hashTable[i]));
+        }
+        for (Pair2& p : stash) out.push_back(move(p));
+        stash.clear();
+        delete[] hashTable;
+    }
+
+    // twice the buckets, every key placed again; doubles again in the unlikely
+    // case that one still doesn't fit
+    void grow() {
+        vector<Pair2> items;
+        takeAll(items);
+        while (true) {
+            buckets *= 2;
+            m = buckets * BUCKET_WIDTH;
+            hashTable = new Pair2[m];
+            int i = 0;
+            while (i < (int)items.size() && place(move(items[i]))) i++;
+            if (i == (int)items.size()) return;
+            vector<Pair2> rest(make_move_iterator(items.begin() + i), make_move_iterator(items.end()));
+            takeAll(rest);
+            items = move(rest);
+        }
+    }
+
+   public:
+    BasicCuckooHashing(int m) {
+        buckets = (m + BUCKET_WIDTH - 1) / BUCKET_WIDTH;
+        this->m = buckets * BUCKET_WIDTH;
+        hashTable = new Pair2[this->m];
+    }
+
+    ~BasicCuckooHashing() { delete[] hashTable; }
+
+    int getSize() { return size; }
+
+    int getStashSize() { return stash.size(); }
+
+    bool search(const K& s, int& p) {
+        int pr = 0, stashIdx;
+        int ret = search_help(s, pr, stashIdx);
+        pr++;  // started from 0 there
+        p = pr;
+        return ret != -1 || stashIdx != -1;
+    }
+
+    int getValue(const K& s) {
+        int pr = 0, stashIdx;
+        int ret = search_help(s, pr, stashIdx);
+        if (ret != -1) return hashTable[ret].value;
+        else if (stashIdx != -1) return stash[stashIdx].value;
+        else return -1;
+    }
+
+    void insert(const K& s, int val) {
+        int temp = 0, stashIdx;
+        int ret = search_help(s, temp, stashIdx);
+        if (ret != -1 || stashIdx != -1) {  // already present, so update the existing value
+            debug("already present before insertion");
+            if (ret != -1) hashTable[ret].value = val;
+            else stash[stashIdx].value = val;
+            return;
+        }
+
+        Pair2 p(s, val);
+        while (!place(move(p))) {
+            debug("stash full, growing", "cuckoo", m);
+            grow();
+        }
+        size++;
+    }
+
+    void remove(const K& s) {
+        int temp = 0, stashIdx;
+        int ret = search_help(s, temp, stashIdx);
+        if (ret == -1 && stashIdx == -1) {
+            debug("not present to delete for cuckoo");
+            return;  // not present
+        }
+        size--;
+        if (stashIdx != -1) {
+            stash.erase(stash.begin() + stashIdx);
+            return;
+        }
+        hashTable[ret].key = K();
+        hashTable[ret].value = -1;
+        // a stashed key that belongs to this bucket can now leave the stash
+        int b = ret / BUCKET_WIDTH;
+        for (int i = 0; i < (int)stash.size(); i++) {
+            int b1, b2;
+            candidates(stash[i].key, b1, b2);
+            if (b1 == b || b2 == b) {
+                hashTable[ret] = move(stash[i]);
+                stash.erase(stash.begin() + i);
+                break;
+            }
+        }
+    }
+};
+
+typedef BasicCuckooHashing<string> CuckooHashing;
@@ -0,0 +1,155 @@
+#pragma once
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "hashing.h"
+
+// Swiss table style probing
+// slots are split into groups of 16 and every slot has a control byte, which is
+// either EMPTY, DELETED or the low 7 bits of the key's hash (h2)
+// one probe = one group: all 16 control bytes are matched against h2 at once,
+// and the keys are compared only where the fragment matched
+const int GROUP_WIDTH = 16;
+const int8_t CTRL_EMPTY = -128;  // 1000 0000
+const int8_t CTRL_DELETED = -2;  // 1111 1110
+
+// bit i of the returned mask is set iff group[i] == b
+inline unsigned matchByte(const int8_t* group, int8_t b) {
+#ifdef __SSE2__
+    __m128i ctrl = _mm_load_si128((const __m128i*)group);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(b)));
+#else
+    unsigned mask = 0;
+    for (int i = 0; i < GROUP_WIDTH; i++) {
+        if (group[i] == b) mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+// EMPTY and DELETED are the only control bytes with the sign bit set
+inline unsigned matchEmptyOrDeleted(const int8_t* group) {
+#ifdef __SSE2__
+    return _mm_movemask_epi8(_mm_load_si128((const __m128i*)group));
+#else
+    unsigned mask = 0;
+    for (int i = 0; i < GROUP_WIDTH; i++) {
+        if (group[i] < 0) mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+template <typename K>
+class BasicGroupProbing {
+   private:
+    typedef BasicPair2<K> Pair2;
+    int m, size = 0, groups;
+    int8_t* ctrl;  // aligned to 16, so that a group is loaded in one go
+    Pair2* hashTable;
+
+    int search_help(const K& s, unsigned long long h, int& probe) {
+        // returns the found index, else -1
+        // probe counts the groups looked at
+        int8_t h2 = h & 0x7F;
+        int g = (h >> 7) % groups;
+        probe = 0;
+        while (probe < groups) {
+            const int8_t* group = ctrl + g * GROUP_WIDTH;
+            unsigned mask = matchByte(group, h2);
+            while (mask) {
+                int idx = g * GROUP_WIDTH + __builtin_ctz(mask);
+                if (hashTable[idx].key == s) return idx;
+                mask &= mask - 1;
+            }
+            // an empty slot means the key would have been put in this group
+            if (matchByte(group, CTRL_EMPTY)) return -1;
+            probe++;
+            g = (g + 1) % groups;
+        }
+        return -1;
+    }
+
+    int search_help(const K& s, int& probe) { return search_help(s, keyHash(s), probe); }
+
+   public:
+    BasicGroupProbing(int m) {
+        groups = (m + GROUP_WIDTH - 1) / GROUP_WIDTH;
+        this->m = groups * GROUP_WIDTH;
+        ctrl = (int8_t*)aligned_alloc(GROUP_WIDTH, this->m);
+        hashTable = new Pair2[this->m];
+        for (int i = 0; i < this->m; i++) ctrl[i] = CTRL_EMPTY;
+    }
+
+    ~BasicGroupProbing() {
+        free(ctrl);
+        delete[] hashTable;
+    }
+
+    int getSize() { return size; }
+
+    bool search(const K& s, int& p) {
+        int pr = 0;
+        int ret = search_help(s, pr);
+        pr++;  // started from 0 there
+        p = pr;
+        if (ret == -1) return false;
+        else return true;
+    }
+
+    int getValue(const K& s) {
+        int pr = 0;
+        int ret = search_help(s, pr);
+        if (ret == -1) return -1;
+        else return hashTable[ret].value;
+    }
+
+    void insert(const K& s, int val) {
+        unsigned long long h = keyHash(s);
+        int temp = 0;
+        int ret = search_help(s, h, temp);
+        if (ret != -1) {  // already present, so update the existing value
+            debug("already present before insertion");
+            hashTable[ret].value = val;
+            return;
+        }
+
+        int g = (h >> 7) % groups;
+        for (int i = 0; i < groups; i++) {
+            unsigned mask = matchEmptyOrDeleted(ctrl + g * GROUP_WIDTH);
+            if (mask) {
+                int j = g * GROUP_WIDTH + __builtin_ctz(mask);
+                ctrl[j] = h & 0x7F;
+                hashTable[j].key = s;
+                hashTable[j].value = val;
+                size++;
+                return;
+            }
+            g = (g + 1) % groups;
+        }
+        debug("can't insert", "group probing", s);
+    }
+
+    void remove(const K& s) {
+        int temp = 0;
+        int ret = search_help(s, temp);
+        if (ret == -1) {
+            debug("not present to delete for group probing");
+            return;  // not present
+        }
+        // if the group still has an empty slot, no search has ever gone past it,
+        // so the slot can become empty again instead of a tombstone
+        int g = ret / GROUP_WIDTH;
+        if (matchByte(ctrl + g * GROUP_WIDTH, CTRL_EMPTY)) ctrl[ret] = CTRL_EMPTY;
+        else ctrl[ret] = CTRL_DELETED;
+        hashTable[ret].key = K();
+        hashTable[ret].value = -1;
+        size--;
+    }
+};
+
+typedef BasicGroupProbing<string> GroupProbing;
@@ -0,0 +1,117 @@
+#pragma once
+#include <string>
+
+#include "hashing.h"
+
+// linear probing where every slot remembers how far it is from its home slot
+// on insertion a key that has travelled further takes the slot from one that
+// is closer to home ("rob the rich"), which keeps probe lengths close together
+// deletion shifts the following keys back by one instead of leaving a
+// tombstone, so the table never fills up with deleted slots
+template <typename K>
+class BasicRobinHoodProbing {
+   private:
+    typedef BasicPair2<K> Pair2;
+    int m, size = 0;
+    Pair2* hashTable;
+    int* dist;  // distance from the home slot, -1 if the slot is empty
+
+    int search_help(const K& s, int& probe) {
+        // returns the found index, else -1
+        int idx = keyHash(s) % m;
+        probe = 0;
+        // once a slot is closer to its home than we are to ours,
+        // the key can't be further along
+        while (probe < m && dist[idx] >= probe) {
+            if (hashTable[idx].key == s) return idx;
+            probe++;
+            idx = idx + 1 == m ? 0 : idx + 1;
+        }
+        return -1;
+    }
+
+   public:
+    BasicRobinHoodProbing(int m) {
+        this->m = m;
+        hashTable = new Pair2[m];
+        dist = new int[m];
+        for (int i = 0; i < m; i++) dist[i] = -1;
+    }
+
+    ~BasicRobinHoodProbing() {
+        delete[] hashTable;
+        delete[] dist;
+    }
+
+    int getSize() { return size; }
+
+    bool search(const K& s, int& p) {
+        int pr = 0;
+        int ret = search_help(s, pr);
+        pr++;  // started from 0 there
+        p = pr;
+        if (ret == -1) return false;
+        else return true;
+    }
+
+    int getValue(const K& s) {
+        int pr = 0;
+        int ret = search_help(s, pr);
+        if (ret == -1) return -1;
+        else return hashTable[ret].value;
+    }
+
+    void insert(const K& s, int val) {
+        int temp = 0;
+        int ret = search_help(s, temp);
+        if (ret != -1) {  // already present, so update the existing value
+            debug("already present before insertion");
+            hashTable[ret].value = val;
+            return;
+        }
+        if (size == m) {
+            debug("can't insert", "robin hood", s);
+            return;
+        }
+
+        Pair2 cur(s, val);
+        int d = 0;
+        int idx = keyHash(s) % m;
+        while (dist[idx] != -1) {
+            if (dist[idx] < d) {
+                // the resident is richer (closer to home), it moves on instead
+                swap(cur, hashTable[idx]);
+                swap(d, dist[idx]);
+            }
+            d++;
+            idx = idx + 1 == m ? 0 : idx + 1;
+        }
+        hashTable[idx] = move(cur);
+        dist[idx] = d;
+        size++;
+    }
+
+    void remove(const K& s) {
+        int temp = 0;
+        int idx = search_help(s, temp);
+        if (idx == -1) {
+            debug("not present to delete for robin hood");
+            return;  // not present
+        }
+        // backward shift: pull every following displaced key one slot closer
+        // to home, up to an empty slot or one already at its home
+        int next = idx + 1 == m ? 0 : idx + 1;
+        while (dist[next] > 0) {
+            hashTable[idx] = move(hashTable[next]);
+            dist[idx] = dist[next] - 1;
+            idx = next;
+            next = next + 1 == m ? 0 : next + 1;
+        }
+        hashTable[idx].key = K();
+        hashTable[idx].value = -1;
+        dist[idx] = -1;
+        size--;
+    }
+};
+
+typedef BasicRobinHoodProbing<string> RobinHoodProbing;
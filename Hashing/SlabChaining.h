@@ -0,0 +1,109 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "hashing.h"
+
+// separate chaining without a heap node per key
+// all entries live in one slab (a vector), chains are linked with 32-bit
+// indices into it, and removed entries go to a free list to be reused
+const uint32_t NIL = UINT32_MAX;
+
+template <typename K>
+struct SlabEntry {
+    K key;
+    int value;
+    uint32_t next;
+};
+
+template <typename K>
+class BasicSlabChaining {
+   private:
+    int m, size = 0;
+    uint32_t* heads;  // index of the first entry of each bucket
+    vector<SlabEntry<K>> slab;
+    uint32_t freeList = NIL;  // removed entries, chained through next
+    // using primaryHash as the hash function here
+
+    // returns the index of the entry, else NIL
+    // prev is set to the entry before it in the chain (NIL if it is the head)
+    uint32_t search_help(const K& s, int h, uint32_t& prev) {
+        prev = NIL;
+        uint32_t cur = heads[h];
+        while (cur != NIL) {
+            if (slab[cur].key == s) return cur;
+            prev = cur;
+            cur = slab[cur].next;
+        }
+        return NIL;
+    }
+
+   public:
+    BasicSlabChaining(int m) {
+        this->m = m;
+        heads = new uint32_t[m];
+        for (int i = 0; i < m; i++) heads[i] = NIL;
+        slab.reserve(m);
+    }
+
+    ~BasicSlabChaining() { delete[] heads; }
+
+    int getSize() { return size; }
+
+    bool search(const K& s) {
+        uint32_t prev;
+        return search_help(s, keyHash(s) % m, prev) != NIL;
+    }
+
+    int getValue(const K& s) {
+        uint32_t prev;
+        uint32_t ret = search_help(s, keyHash(s) % m, prev);
+        if (ret == NIL) return -1;  // not found
+        else return slab[ret].value;
+    }
+
+    void insert(const K& s, int val) {
+        int h = keyHash(s) % m;
+        uint32_t prev;
+        uint32_t ret = search_help(s, h, prev);
+        if (ret != NIL) {
+            debug("already present before insertion");
+            slab[ret].value = val;
+            return;
+        }
+
+        uint32_t idx;
+        if (freeList != NIL) {
+            idx = freeList;
+            freeList = slab[idx].next;
+            slab[idx].key = s;
+            slab[idx].value = val;
+        } else {
+            idx = slab.size();
+            slab.push_back({s, val, NIL});
+        }
+        slab[idx].next = heads[h];
+        heads[h] = idx;
+        size++;
+    }
+
+    void remove(const K& s) {
+        int h = keyHash(s) % m;
+        uint32_t prev;
+        uint32_t ret = search_help(s, h, prev);
+        if (ret == NIL) {
+            debug("not present to delete for slab chaining");
+            return;  // not present
+        }
+        if (prev == NIL) heads[h] = slab[ret].next;
+        else slab[prev].next = slab[ret].next;
+        slab[ret].key = K();
+        slab[ret].value = -1;
+        slab[ret].next = freeList;
+        freeList = ret;
+        size--;
+    }
+};
+
+typedef BasicSlabChaining<string> SlabChaining;
@@ -0,0 +1,205 @@
+#pragma once
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "hashing.h"
+
+// snapshot of a Probing table on disk
+// the file is the slot array as is (same m, same probe sequence) followed by
+// one pool with the bytes of every key, and every pointer in it is an offset,
+// so it can be mmap'ed and searched in place: loading does no parsing and
+// no allocation per entry
+//
+// layout: SnapshotHeader | SnapshotSlot[m] | key bytes
+const char SNAPSHOT_MAGIC[8] = {'H', 'S', 'N', 'A', 'P', '0', '1', '\0'};
+const uint32_t SNAPSHOT_TOMBSTONE = UINT32_MAX;  // keyLen of a deleted slot
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t m, size;
+    int32_t method;    // resolutionMethod
+    int32_t keyWidth;  // 0 for std::string keys, else the FixedKey width
+    int32_t hashId;    // which primaryHash the table was built with
+    uint32_t reserved;
+    uint64_t poolOffset, poolSize;  // from the start of the file
+};
+
+struct SnapshotSlot {
+    uint64_t keyOffset;  // into the key pool
+    uint32_t keyLen;     // 0 for an empty slot, SNAPSHOT_TOMBSTONE for a deleted one
+    int32_t value;       // -1 unless the slot is in use
+};
+
+inline int hashId(HashFunction f) {
+    if (f == hash3) return 3;
+    else if (f == hash4) return 4;
+    else return 1;
+}
+
+inline HashFunction hashById(int id) {
+    if (id == 3) return hash3;
+    else if (id == 4) return hash4;
+    else return hash1;
+}
+
+inline string keyString(const string& s) { return s; }
+
+template <int W>
+string keyString(const FixedKey<W>& k) {
+    return k.str();
+}
+
+inline int keyWidthOf(const string*) { return 0; }
+
+template <int W>
+int keyWidthOf(const FixedKey<W>*) {
+    return W;
+}
+
+template <typename K>
+bool saveSnapshot(BasicProbing<K>& table, const string& path) {
+    vector<SnapshotSlot> slots;
+    string pool;
+    table.forEachSlot([&](int, const K& key, int value, bool deleted) {
+        SnapshotSlot slot;
+        slot.value = value;
+        if (value == -1) {
+            slot.keyOffset = 0;
+            slot.keyLen = deleted ? SNAPSHOT_TOMBSTONE : 0;
+        } else {
+            string bytes = keyString(key);
+            slot.keyOffset = pool.size();
+            slot.keyLen = bytes.size();
+            pool += bytes;
+        }
+        slots.push_back(slot);
+    });
+
+    SnapshotHeader header;
+    memcpy(header.magic, SNAPSHOT_MAGIC, 8);
+    header.m = slots.size();
+    header.size = table.getSize();
+    header.method = table.getProbingMethod();
+    header.keyWidth = keyWidthOf((K*)nullptr);
+    header.hashId = hashId(primaryHash);
+    header.reserved = 0;
+    header.poolOffset = sizeof(SnapshotHeader) + slots.size() * sizeof(SnapshotSlot);
+    header.poolSize = pool.size();
+
+    ofstream out(path, ios::binary | ios::trunc);
+    if (!out) return false;
+    out.write((const char*)&header, sizeof(header));
+    out.write((const char*)slots.data(), slots.size() * sizeof(SnapshotSlot));
+    out.write(pool.data(), pool.size());
+    return (bool)out;
+}
+
+// read-only table served straight from a mapped snapshot
+class ProbingSnapshot {
+   private:
+    int fd = -1;
+    void* base = MAP_FAILED;
+    size_t length = 0;
+    const SnapshotHeader* header = nullptr;
+    const SnapshotSlot* slots = nullptr;
+    const char* pool = nullptr;
+
+    // the table hashed keys of its own type, so hash the query the same way
+    unsigned long long homeHash(const string& s) {
+        if (header->keyWidth == 8) return keyHash(FixedKey<8>(s));
+        else if (header->keyWidth == 16) return keyHash(FixedKey<16>(s));
+        else return hashById(header->hashId)(s, MOD);
+    }
+
+    unsigned long long stepHash(const string& s) {
+        if (header->method != DoubleHashing) return 0;
+        if (header->keyWidth == 8) return keyHash2(FixedKey<8>(s), header->m);
+        else if (header->keyWidth == 16) return keyHash2(FixedKey<16>(s), header->m);
+        else return hash2(s, header->m);
+    }
+
+    int search_help(const string& s, int& probe) {
+        // returns the found index, else -1
+        probe = 0;
+        if (header->keyWidth != 0 && (int)s.size() > header->keyWidth) return -1;  // can't be stored
+        int m = header->m;
+        resolutionMethod p = (resolutionMethod)header->method;
+        unsigned long long home = homeHash(s) % m, step = stepHash(s);
+        while (probe < m) {
+            const SnapshotSlot& slot = slots[probeIndex(p, home, step, probe, m)];
+            if (slot.value != -1) {
+                if (slot.keyLen == s.size() && memcmp(pool + slot.keyOffset, s.data(), s.size()) == 0)
+                    return probeIndex(p, home, step, probe, m);
+            } else if (slot.keyLen != SNAPSHOT_TOMBSTONE) {
+                return -1;  // empty, not deleted
+            }
+            probe++;
+        }
+        return -1;
+    }
+
+    void unmap() {
+        if (base != MAP_FAILED) munmap(base, length);
+        if (fd != -1) close(fd);
+        base = MAP_FAILED;
+        fd = -1;
+        header = nullptr;
+    }
+
+   public:
+    ~ProbingSnapshot() { unmap(); }
+
+    bool load(const string& path) {
+        unmap();
+        fd = open(path.c_str(), O_RDONLY);
+        if (fd == -1) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(SnapshotHeader)) {
+            unmap();
+            return false;
+        }
+        length = st.st_size;
+        base = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) {
+            unmap();
+            return false;
+        }
+        header = (const SnapshotHeader*)base;
+        if (memcmp(header->magic, SNAPSHOT_MAGIC, 8) != 0 ||
+            header->poolOffset + header->poolSize > length ||
+            sizeof(SnapshotHeader) + header->m * sizeof(SnapshotSlot) > header->poolOffset) {
+            debug("not a valid snapshot", path);
+            unmap();
+            return false;
+        }
+        slots = (const SnapshotSlot*)((const char*)base + sizeof(SnapshotHeader));
+        pool = (const char*)base + header->poolOffset;
+        return true;
+    }
+
+    int getSize() { return header->size; }
+
+    bool search(const string& s, int& p) {
+        int pr = 0;
+        int ret = search_help(s, pr);
+        pr++;  // started from 0 there
+        p = pr;
+        if (ret == -1) return false;
+        else return true;
+    }
+
+    int getValue(const string& s) {
+        int pr = 0;
+        int ret = search_help(s, pr);
+        if (ret == -1) return -1;
+        else return slots[ret].value;
+    }
+};
@@ -0,0 +1,190 @@
+#pragma once
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "hashing.h"
+
+// key workloads for the tables
+// - generate_unique: n distinct random keys, generated and deduplicated by all
+//   the threads; the keys depend only on the seed, not on the thread count
+// - KeyStream: an endless stream of keys drawn uniformly, from a Zipf
+//   distribution or in sequence out of a universe of distinct keys; nothing is
+//   stored, key number i is computed when it is needed, so the universe can be
+//   far bigger than memory
+enum KeyDistribution { Uniform, Zipfian, Sequential };
+
+const int GEN_BLOCK = 4096;  // candidates drawn from one seeded generator
+
+// splitmix64 finalizer, turns (seed, block) into independent generator seeds
+inline unsigned long long mixSeed(unsigned long long x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// writes len letters, 13 of them from every 64 bit draw (26^13 < 2^62)
+template <typename Rng>
+void randomWord(Rng& rng, int len, string& out) {
+    out.resize(len);
+    for (int i = 0; i < len; i += 13) {
+        unsigned long long r = rng();
+        for (int j = i; j < min(len, i + 13); j++, r /= 26) out[j] = 'a' + r % 26;
+    }
+}
+
+// number of distinct words of length len, capped at 26^13
+inline unsigned long long wordSpace(int len) {
+    unsigned long long space = 1;
+    for (int i = 0; i < min(len, 13); i++) space *= 26;
+    return space;
+}
+
+vector<string> generate_unique(int n, int len, unsigned long long seed, int threads = defaultThreads()) {
+    assert((unsigned long long)n <= wordSpace(len));
+    vector<string> strings;
+    strings.reserve(n);
+    // seen[t] holds the keys whose hash falls in shard t, only thread t touches it
+    vector<unordered_set<string>> seen(threads);
+    for (auto& s : seen) s.reserve(n / threads + 1);
+    vector<string> cand;
+    vector<int> shard;
+    vector<char> keep;
+    for (unsigned long long round = 0; (int)strings.size() < n; round++) {
+        // a few spare candidates, so one round is nearly always enough
+        int want = n - strings.size();
+        int count = want + want / 64 + 16;
+        int blocks = (count + GEN_BLOCK - 1) / GEN_BLOCK;
+        cand.resize(count);
+        shard.resize(count);
+        keep.assign(count, 0);
+        parallelFor(threads, [&](int t) {
+            for (int b = t; b < blocks; b += threads) {
+                mt19937_64 rng(mixSeed(seed ^ mixSeed(round << 32 | b)));
+                for (int i = b * GEN_BLOCK; i < min(count, (b + 1) * GEN_BLOCK); i++) {
+                    randomWord(rng, len, cand[i]);
+                    shard[i] = hash<string>()(cand[i]) % threads;
+                }
+            }
+        });
+        // the first copy of every key wins, whichever shard it is in
+        parallelFor(threads, [&](int t) {
+            for (int i = 0; i < count; i++) {
+                if (shard[i] == t && seen[t].insert(cand[i]).second) keep[i] = 1;
+            }
+        });
+        for (int i = 0; i < count && (int)strings.size() < n; i++) {
+            if (keep[i]) strings.push_back(move(cand[i]));
+        }
+    }
+    return strings;
+}
+
+// n distinct random keys of length len, seeded from rand() so srand still
+// decides which keys a run gets
+vector<string> generate_strings(int n, int len) { return generate_unique(n, len, rand()); }
+
+// Zipf distribution over 1..n, P(k) proportional to 1 / k^skew
+// rejection-inversion sampling (Hörmann and Derflinger), O(1) per sample
+// and no table, whatever n is
+class ZipfSampler {
+   private:
+    double skew, hX1, hN, s;
+    unsigned long long n;
+
+    // log(1 + x) / x and (exp(x) - 1) / x, accurate near 0
+    static double helper1(double x) { return fabs(x) > 1e-8 ? log1p(x) / x : 1 - x / 2; }
+    static double helper2(double x) { return fabs(x) > 1e-8 ? expm1(x) / x : 1 + x / 2; }
+
+    double h(double x) { return exp(-skew * log(x)); }
+    double hIntegral(double x) {
+        double lx = log(x);
+        return helper2((1 - skew) * lx) * lx;
+    }
+    double hIntegralInverse(double x) {
+        double t = max(-1.0, x * (1 - skew));
+        return exp(helper1(t) * x);
+    }
+
+   public:
+    ZipfSampler(unsigned long long n = 1, double skew = 0.99) : skew(skew), n(n) {
+        hX1 = hIntegral(1.5) - 1;
+        hN = hIntegral(n + 0.5);
+        s = 2 - hIntegralInverse(hIntegral(2.5) - h(2));
+    }
+
+    template <typename Rng>
+    unsigned long long operator()(Rng& rng) {
+        uniform_real_distribution<double> unit(0, 1);
+        while (true) {
+            double u = hN + unit(rng) * (hX1 - hN);
+            double x = hIntegralInverse(u);
+            unsigned long long k = x + 0.5;
+            k = max(1ull, min(k, n));
+            if (k - x <= s || u >= hIntegral(k + 0.5) - h(k)) return k;
+        }
+    }
+};
+
+// one stream per thread: give every thread its own seed
+class KeyStream {
+   private:
+    KeyDistribution dist;
+    unsigned long long universe, space, mult, offset, counter = 0;
+    int len;
+    mt19937_64 rng;
+    ZipfSampler zipf;
+
+   public:
+    KeyStream(KeyDistribution dist, unsigned long long universe, unsigned long long seed,
+              int len = string_len, double skew = 0.99)
+        : dist(dist), universe(universe), len(len), rng(mixSeed(seed)), zipf(universe, skew) {
+        space = wordSpace(len);
+        assert(universe <= space);
+        // an affine map mod 26^k is a bijection when the multiplier shares no
+        // factor with 26, so distinct ids give distinct keys and the hot ids
+        // land all over the key space instead of next to each other
+        mult = (mixSeed(seed + 1) % space) | 1;
+        if (mult % 13 == 0) mult += 2;
+        offset = mixSeed(seed + 2) % space;
+    }
+
+    unsigned long long getUniverse() { return universe; }
+
+    // the id of the next key, in 0..universe-1; with Zipfian 0 is the hottest
+    unsigned long long nextId() {
+        if (dist == Sequential) {
+            unsigned long long id = counter++;
+            if (counter == universe) counter = 0;
+            return id;
+        } else if (dist == Zipfian) {
+            return zipf(rng) - 1;
+        } else {
+            return uniform_int_distribution<unsigned long long>(0, universe - 1)(rng);
+        }
+    }
+
+    // the key with this id, the same every time; sequential ids give keys in
+    // counting order
+    void keyOf(unsigned long long id, string& out) {
+        unsigned long long x = id;
+        if (dist != Sequential) x = ((unsigned __int128)x * mult + offset) % space;
+        out.assign(len, 'a');
+        for (int i = min(len, 13) - 1; i >= 0; i--, x /= 26) out[i] = 'a' + x % 26;
+        // past 13 letters the key is already unique, the rest only pads it
+        for (int i = 13; i < len; i++) out[i] = 'a' + mixSeed(id + i) % 26;
+    }
+
+    string keyOf(unsigned long long id) {
+        string s;
+        keyOf(id, s);
+        return s;
+    }
+
+    string next() { return keyOf(nextId()); }
+};
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "Cuckoo.h"
+#include "GroupProbing.h"
+#include "RobinHood.h"
+#include "SlabChaining.h"
+#include "Workload.h"
+#include "benchmark.h"
+#include "hashing.h"
+using namespace std;
+
+// usage: benchmark [--n N] [--trials T] [--batch B] [--hash wyhash|xxh3]
+//                  [--dist uniform|zipf|sequential] [--skew S]
+//                  [--csv file] [--json file]
+// every table is run at a few load factors of an N slot table, for
+// inserts into an empty table, lookups of present keys, lookups of absent
+// keys and removes
+// --dist picks which present keys are looked up (zipf models skewed traffic,
+// where a few keys take most of the lookups); removes always take distinct
+// present keys, so none of them misses
+BenchConfig cfg;
+int N = 100003;
+KeyDistribution dist = Uniform;
+double skew = 0.99;
+vector<BenchResult> results;
+volatile long long sink;  // keeps lookups from being optimized out
+
+void report(const BenchResult& r) {
+    results.push_back(r);
+    cerr << setw(22) << left << r.table << setw(10) << r.op << " lf " << r.lf << ": " << fixed
+         << setprecision(0) << r.opsPerSec << " ops/sec (+-" << r.opsPerSecStd << "), batch-mean p50 "
+         << setprecision(1) << r.p50 << "ns, p99 " << r.p99 << "ns, p999 " << r.p999 << "ns";
+    if (r.cacheMisses >= 0) cerr << ", " << setprecision(2) << r.cacheMisses << " cache misses/op";
+    if (r.branchMisses >= 0) cerr << ", " << r.branchMisses << " branch misses/op";
+    cerr << "\n";
+}
+
+// make() returns a new, empty table keyed by K; strings are already
+// converted to K, so the timed ops never convert a key
+template <typename Table, typename Make, typename K>
+void benchTable(const string& name, Make make, const vector<K>& strings) {
+    for (double lf : {0.5, 0.7, 0.9}) {
+        int needed = lf * N;
+        int q = max(1, needed / 10);
+        vector<K> hits(q);
+        KeyStream picks(dist, needed, 2023, string_len, skew);
+        for (auto& s : hits) s = strings[picks.nextId()];
+        vector<K> misses(strings.begin() + needed, strings.begin() + needed + q);
+        vector<int> order(needed);
+        iota(order.begin(), order.end(), 0);
+        shuffle(order.begin(), order.end(), mt19937(2023));
+        vector<K> doomed(q);
+        for (int i = 0; i < q; i++) doomed[i] = strings[order[i]];
+
+        unique_ptr<Table> table;
+        auto build = [&]() {
+            table.reset(make());
+            for (int i = 0; i < needed; i++) table->insert(strings[i], i + 1);
+        };
+
+        report(measure(
+            cfg, name, "insert", lf, needed, [&]() { table.reset(make()); },
+            [&](int i) { table->insert(strings[i], i + 1); }));
+        build();
+        report(measure(
+            cfg, name, "get_hit", lf, q, []() {}, [&](int i) { sink += table->getValue(hits[i]); }));
+        report(measure(
+            cfg, name, "get_miss", lf, q, []() {},
+            [&](int i) { sink += table->getValue(misses[i]); }));
+        report(measure(cfg, name, "remove", lf, q, build, [&](int i) { table->remove(doomed[i]); }));
+    }
+}
+
+int main(int argc, char* argv[]) {
+    string csvPath, jsonPath;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string flag = argv[i], val = argv[i + 1];
+        if (flag == "--n") N = stoi(val);
+        else if (flag == "--trials") cfg.trials = stoi(val);
+        else if (flag == "--batch") cfg.batch = stoi(val);
+        else if (flag == "--csv") csvPath = val;
+        else if (flag == "--json") jsonPath = val;
+        else if (flag == "--skew") skew = stod(val);
+        else if (flag == "--dist") {
+            if (val == "zipf") dist = Zipfian;
+            else if (val == "sequential") dist = Sequential;
+        }
+        else if (flag == "--hash") {
+            if (val == "wyhash") primaryHash = hash3;
+            else if (val == "xxh3") primaryHash = hash4;
+        }
+    }
+    srand(2023);  // same keys every run, so runs can be compared
+    // 0.9 N keys to insert plus 10% of that to look up as misses
+    vector<string> strings = generate_strings(N, string_len);
+    vector<ShortKey> shortKeys = asKeys<ShortKey>(strings);
+
+    benchTable<SeparateChaining>("separate_chaining", []() { return new SeparateChaining(N); }, strings);
+    benchTable<SlabChaining>("slab_chaining", []() { return new SlabChaining(N); }, strings);
+    benchTable<BasicSeparateChaining<ShortKey>>(
+        "separate_chaining_short", []() { return new BasicSeparateChaining<ShortKey>(N); }, shortKeys);
+    const resolutionMethod methods[] = {LinearProbing, QuadraticProbing, DoubleHashing};
+    const string names[] = {"linear_probing", "quadratic_probing", "double_hashing"};
+    for (int k = 0; k < 3; k++) {
+        resolutionMethod p = methods[k];
+        benchTable<Probing>(
+            names[k],
+            [p]() {
+                Probing* t = new Probing(N);
+                t->setProbingMethod(p);
+                return t;
+            },
+            strings);
+    }
+    benchTable<BasicProbing<ShortKey>>(
+        "linear_probing_short",
+        []() {
+            BasicProbing<ShortKey>* t = new BasicProbing<ShortKey>(N);
+            t->setProbingMethod(LinearProbing);
+            return t;
+        },
+        shortKeys);
+    benchTable<RobinHoodProbing>("robin_hood", []() { return new RobinHoodProbing(N); }, strings);
+    benchTable<GroupProbing>("group_probing", []() { return new GroupProbing(N); }, strings);
+    benchTable<CuckooHashing>("cuckoo", []() { return new CuckooHashing(N); }, strings);
+
+    if (csvPath.empty() && jsonPath.empty()) writeCSV(results, cout);
+    if (!csvPath.empty()) {
+        ofstream out(csvPath);
+        writeCSV(results, out);
+    }
+    if (!jsonPath.empty()) {
+        ofstream out(jsonPath);
+        writeJSON(results, out);
+    }
+    return 0;
+}
@@ -0,0 +1,203 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// benchmark harness for the hash tables
+// - warm-up pass before anything is timed
+// - ops are timed in batches, so one clock read is spread over many ~50 ns
+//   operations, and the clock's own cost is measured once and subtracted
+// - several trials, ops/sec reported as mean and standard deviation
+// - p50/p99/p999 over the batch means (batch time / ops in the batch) of every
+//   trial, so one slow op in a batch is diluted up to batch times; they are
+//   labelled batch-mean percentiles, and --batch 1 makes them per-op ones
+// - cache and branch misses per op through perf_event_open, when the kernel
+//   lets us (otherwise they are reported as missing)
+
+struct BenchConfig {
+    int trials = 5;
+    int batch = 16;       // ops per clock read
+    int warmup = 100000;  // ops run untimed before the first trial
+};
+
+struct BenchResult {
+    string table, op;
+    double lf;
+    int trials;
+    long long ops;  // per trial
+    double opsPerSec, opsPerSecStd;
+    double p50, p99, p999;             // ns per op, percentiles of the batch means
+    double cacheMisses, branchMisses;  // per op, -1 if not available
+};
+
+typedef chrono::steady_clock benchClock;
+
+enum PerfEvent { CACHE_MISSES, BRANCH_MISSES };
+
+class PerfCounter {
+   private:
+    int fd = -1;
+
+   public:
+    PerfCounter(PerfEvent event) {
+#ifdef __linux__
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = event == CACHE_MISSES ? PERF_COUNT_HW_CACHE_MISSES : PERF_COUNT_HW_BRANCH_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+    }
+
+    ~PerfCounter() {
+#ifdef __linux__
+        if (fd != -1) close(fd);
+#endif
+    }
+
+    bool available() const { return fd != -1; }
+
+    void start() {
+#ifdef __linux__
+        if (fd == -1) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    long long stop() {
+        long long count = 0;
+#ifdef __linux__
+        if (fd == -1) return -1;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd, &count, sizeof(count)) != sizeof(count)) return -1;
+#endif
+        return count;
+    }
+};
+
+// cost of reading the clock twice, median of many tries, in ns
+double clockOverhead() {
+    vector<double> samples(10000);
+    for (auto& s : samples) {
+        auto start = benchClock::now();
+        auto end = benchClock::now();
+        s = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+    }
+    nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+    return samples[samples.size() / 2];
+}
+
+double percentile(vector<double>& sorted, double q) {
+    if (sorted.empty()) return 0;
+    int idx = min((int)sorted.size() - 1, (int)(q * sorted.size()));
+    return sorted[idx];
+}
+
+// runs op(0), op(1), ..., op(ops - 1) once per trial, after setup()
+// setup is untimed and rebuilds whatever state op changes (e.g. a fresh
+// table for inserts)
+template <typename Setup, typename Op>
+BenchResult measure(const BenchConfig& cfg, const string& table, const string& opName, double lf,
+                    int ops, Setup setup, Op op) {
+    static double overhead = clockOverhead();
+    PerfCounter cacheCounter(CACHE_MISSES);
+    PerfCounter branchCounter(BRANCH_MISSES);
+
+    setup();
+    for (int i = 0; i < min(ops, cfg.warmup); i++) op(i);
+
+    vector<double> latencies, rates;
+    long long cacheMisses = 0, branchMisses = 0;
+    for (int t = 0; t < cfg.trials; t++) {
+        setup();
+        cacheCounter.start();
+        branchCounter.start();
+        auto trialStart = benchClock::now();
+        for (int i = 0; i < ops; i += cfg.batch) {
+            int end = min(ops, i + cfg.batch);
+            auto start = benchClock::now();
+            for (int j = i; j < end; j++) op(j);
+            double ns = chrono::duration_cast<chrono::nanoseconds>(benchClock::now() - start).count();
+            latencies.push_back(max(0.0, ns - overhead) / (end - i));
+        }
+        double secs =
+            chrono::duration_cast<chrono::nanoseconds>(benchClock::now() - trialStart).count() / 1e9;
+        cacheMisses += cacheCounter.stop();
+        branchMisses += branchCounter.stop();
+        rates.push_back(ops / secs);
+    }
+
+    BenchResult r;
+    r.table = table;
+    r.op = opName;
+    r.lf = lf;
+    r.trials = cfg.trials;
+    r.ops = ops;
+    r.opsPerSec = 0;
+    for (double x : rates) r.opsPerSec += x / rates.size();
+    r.opsPerSecStd = 0;
+    for (double x : rates) r.opsPerSecStd += (x - r.opsPerSec) * (x - r.opsPerSec) / rates.size();
+    r.opsPerSecStd = sqrt(r.opsPerSecStd);
+    sort(latencies.begin(), latencies.end());
+    r.p50 = percentile(latencies, 0.5);
+    r.p99 = percentile(latencies, 0.99);
+    r.p999 = percentile(latencies, 0.999);
+    long long totalOps = (long long)ops * cfg.trials;
+    r.cacheMisses = cacheCounter.available() ? (double)cacheMisses / totalOps : -1;
+    r.branchMisses = branchCounter.available() ? (double)branchMisses / totalOps : -1;
+    return r;
+}
+
+void writeCSV(const vector<BenchResult>& results, ostream& out) {
+    out.precision(10);
+    out << "table,op,load_factor,trials,ops,ops_per_sec,ops_per_sec_std,batch_p50_ns,batch_p99_ns,"
+           "batch_p999_ns,"
+           "cache_misses_per_op,branch_misses_per_op\n";
+    for (auto& r : results) {
+        out << r.table << "," << r.op << "," << r.lf << "," << r.trials << "," << r.ops << ","
+            << r.opsPerSec << "," << r.opsPerSecStd << "," << r.p50 << "," << r.p99 << ","
+            << r.p999 << ",";
+        if (r.cacheMisses >= 0) out << r.cacheMisses;
+        out << ",";
+        if (r.branchMisses >= 0) out << r.branchMisses;
+        out << "\n";
+    }
+}
+
+void writeJSON(const vector<BenchResult>& results, ostream& out) {
+    out.precision(10);
+    out << "[\n";
+    for (int i = 0; i < (int)results.size(); i++) {
+        const BenchResult& r = results[i];
+        out << "  {\"table\": \"" << r.table << "\", \"op\": \"" << r.op
+            << "\", \"load_factor\": " << r.lf << ", \"trials\": " << r.trials
+            << ", \"ops\": " << r.ops << ", \"ops_per_sec\": " << r.opsPerSec
+            << ", \"ops_per_sec_std\": " << r.opsPerSecStd << ", \"batch_p50_ns\": " << r.p50
+            << ", \"batch_p99_ns\": " << r.p99 << ", \"batch_p999_ns\": " << r.p999 << ", \"cache_misses_per_op\": ";
+        if (r.cacheMisses >= 0) out << r.cacheMisses;
+        else out << "null";
+        out << ", \"branch_misses_per_op\": ";
+        if (r.branchMisses >= 0) out << r.branchMisses;
+        else out << "null";
+        out << "}" << (i + 1 < (int)results.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+}
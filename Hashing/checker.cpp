@@ -1,5 +1,6 @@
 #include <bits/stdc++.h>
 
+#include "Workload.h"
 #include "hashing.h"
 using namespace std;
 
@@ -1,14 +1,43 @@
 #pragma once
+#include <chrono>
+#include <cassert>
+#include <climits>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <set>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <vector>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 #include "debug.h"
 const int string_len = 7;
 const int MOD = 1e9 + 7;
 const int c1 = 1;
 const int c2 = 1;
+// tables grow once their load factor would go past these
+const double MAX_LOAD_CHAINING = 1.0;
+const double MAX_LOAD_PROBING = 0.95;
+// entries (or buckets) moved from the old table per insert/remove while growing
+const int REHASH_STEP = 64;
+
+bool isPrimeNumber(int x) {
+    if (x < 2) return false;
+    for (long long d = 2; d * d <= x; d++) {
+        if (x % d == 0) return false;
+    }
+    return true;
+}
+
+int nextPrimeNumber(int x) {
+    while (!isPrimeNumber(x)) x++;
+    return x;
+}
 
 string generate_random_word(int len = string_len) {
     string ret = "";
@@ -20,21 +49,6 @@ string generate_random_word(int len = string_len) {
     return ret;
 }
 
-vector<string> generate_strings(int n, int len) {
-    set<string> str;  // to ensure no word is duplicated
-    vector<string> strings(n);
-    int idx = 0;
-    while (idx < n) {
-        string s = generate_random_word(len);
-        if (str.count(s)) continue;
-        else {
-            str.insert(s);
-            strings[idx++] = s;
-        }
-    }
-    return strings;
-}
-
 // Polynomial Rolling
 unsigned long long hash1(const string& s, const int N = MOD) {
     unsigned long long hash_value = 0;
@@ -66,42 +80,328 @@ unsigned long long hash2(const string& s, const int N) {
     return hash_value % (N - 1) + 1;
 }
 
-double test_hash(unsigned long long (*func)(const string&, const int), int N) {
+// hash1 does two modulo operations per character, the ones below take 8 to 32
+// bytes per step and only multiply, xor and shift
+inline uint64_t read64(const char* p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+inline uint64_t read32(const char* p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+// 64x64 -> 128 bit multiply, folded back to 64 bits
+inline uint64_t mum(uint64_t a, uint64_t b) {
+    __uint128_t r = (__uint128_t)a * b;
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+}
+
+const uint64_t secret[4] = {0xa0761d6478bd642full, 0xe7037ed1a0b428dbull,
+                            0x8ebc6af09c88c6e3ull, 0x589965cc75374cc1ull};
+
+// wyhash style: 16 bytes per step (48 with three lanes for long keys)
+// hash3 and hash4 return all 64 bits, the table size only comes in when the
+// tables take them modulo m, so the size parameter is unused
+unsigned long long hash3(const string& s, const int = MOD) {
+    const char* p = s.data();
+    size_t len = s.size();
+    uint64_t seed = mum(secret[0], secret[1]);
+    uint64_t a, b;
+    if (len <= 16) {
+        if (len >= 4) {
+            // two overlapping reads cover any length from 4 to 16
+            a = (read32(p) << 32) | read32(p + ((len >> 3) << 2));
+            b = (read32(p + len - 4) << 32) | read32(p + len - 4 - ((len >> 3) << 2));
+        } else if (len > 0) {
+            a = ((uint64_t)(uint8_t)p[0] << 16) | ((uint64_t)(uint8_t)p[len >> 1] << 8) |
+                (uint8_t)p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = mum(read64(p) ^ secret[1], read64(p + 8) ^ seed);
+                see1 = mum(read64(p + 16) ^ secret[2], read64(p + 24) ^ see1);
+                see2 = mum(read64(p + 32) ^ secret[3], read64(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = mum(read64(p) ^ secret[1], read64(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = read64(p + i - 16);
+        b = read64(p + i - 8);
+    }
+    return mum(secret[1] ^ len, mum(a ^ secret[1], b ^ seed));
+}
+
+// xxh3 style: four 64-bit accumulators fed 32 bytes per step
+// the AVX2 path and the scalar path compute exactly the same thing
+inline void accumulate32(uint64_t* acc, const char* p, const uint64_t* key) {
+#ifdef __AVX2__
+    __m256i a = _mm256_loadu_si256((const __m256i*)acc);
+    __m256i data = _mm256_loadu_si256((const __m256i*)p);
+    __m256i keyed = _mm256_xor_si256(data, _mm256_loadu_si256((const __m256i*)key));
+    // lo32 * hi32 of every lane
+    __m256i product = _mm256_mul_epu32(keyed, _mm256_srli_epi64(keyed, 32));
+    a = _mm256_add_epi64(a, _mm256_add_epi64(data, product));
+    _mm256_storeu_si256((__m256i*)acc, a);
+#else
+    for (int l = 0; l < 4; l++) {
+        uint64_t data = read64(p + 8 * l);
+        uint64_t keyed = data ^ key[l];
+        acc[l] += data + (keyed & 0xFFFFFFFFull) * (keyed >> 32);
+    }
+#endif
+}
+
+unsigned long long hash4(const string& s, const int = MOD) {
+    const char* p = s.data();
+    size_t len = s.size();
+    if (len <= 16) return hash3(s);  // too short for the accumulators to pay off
+    uint64_t acc[4] = {secret[0], secret[1], secret[2], secret[3]};
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) accumulate32(acc, p + i, secret);
+    // last 32 bytes (overlapping) take care of the tail
+    if (i < len && len >= 32) accumulate32(acc, p + len - 32, secret);
+    uint64_t h = len * secret[0];
+    if (len < 32) {
+        // less than one full block: mix the two halves directly
+        h ^= mum(read64(p) ^ secret[1], read64(p + len - 8) ^ secret[2]);
+        h ^= mum(read64(p + 8) ^ secret[3], read64(p + len - 16) ^ h);
+    }
+    h += mum(acc[0] ^ secret[2], acc[1] ^ secret[3]);
+    h += mum(acc[2] ^ secret[0], acc[3] ^ secret[1]);
+    // avalanche
+    h ^= h >> 37;
+    h *= 0x165667919e3779f9ull;
+    h ^= h >> 32;
+    return h;
+}
+
+typedef unsigned long long (*HashFunction)(const string&, const int);
+
+// the hash every table uses for its home slot (hash2 stays the step for
+// double hashing); computed once per operation
+HashFunction primaryHash = hash1;
+
+struct HashStats {
+    double rate;           // unique hash values / keys
+    double collisionRate;  // keys that landed on an already taken hash value
+    double throughput;     // GB/s hashing keys of string_len characters
+    double longThroughput; // GB/s hashing 1 KB keys
+};
+
+unsigned long long hashSink;  // a global, so the hashing loops are not optimized out
+
+// bytes hashed per second, over `rounds` passes through strs
+double hashThroughput(HashFunction func, const vector<string>& strs, int rounds) {
+    unsigned long long sink = 0;
+    double bytes = 0;
+    for (auto& s : strs) bytes += s.size();
+    auto start = chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (auto& s : strs) sink ^= func(s, MOD);
+    }
+    double secs = chrono::duration_cast<chrono::nanoseconds>(
+                      chrono::high_resolution_clock::now() - start)
+                      .count() /
+                  1e9;
+    hashSink = sink;
+    return bytes * rounds / secs / 1e9;
+}
+
+HashStats test_hash(HashFunction func, int N, int dataset_size = 100) {
     set<string> str;
-    set<int> hash_values;
-    int dataset_size = 100;
+    set<unsigned long long> hash_values;
     while (str.size() < dataset_size) {
         string s = generate_random_word(string_len);
         str.insert(s);
     }
     for (auto& s : str) hash_values.insert(func(s, MOD) % N);
-    double rate = ((int)hash_values.size() * 1.00) / dataset_size;
-    // debug(rate);
-    return rate;
+    HashStats stats;
+    stats.rate = ((int)hash_values.size() * 1.00) / dataset_size;
+    stats.collisionRate = 1 - stats.rate;
+    // debug(stats.rate);
+
+    vector<string> shortKeys(1 << 16), longKeys(256);
+    for (auto& s : shortKeys) s = generate_random_word(string_len);
+    for (auto& s : longKeys) s = generate_random_word(1024);
+    stats.throughput = hashThroughput(func, shortKeys, 64);
+    stats.longThroughput = hashThroughput(func, longKeys, 256);
+    return stats;
 }
 
-struct Pair {
+// parallel bulk loading
+// runs f(0), ..., f(threads - 1), each on its own thread
+template <typename F>
+void parallelFor(int threads, F f) {
+    vector<thread> workers;
+    for (int t = 1; t < threads; t++) workers.emplace_back(f, t);
+    f(0);
+    for (auto& w : workers) w.join();
+}
+
+int defaultThreads() { return max(1u, thread::hardware_concurrency()); }
+
+// which of the `parts` equal slot ranges of a table of size m holds slot s
+inline int slotPart(int s, int m, int parts) { return (long long)s * parts / m; }
+
+// stable radix scatter of the keys 0..n-1 by slot range, one thread per part
+// the keys whose slot lies in part p end up in order[start[p] .. start[p + 1]),
+// in input order
+void scatterBySlot(const vector<int>& slot, int m, int parts, vector<int>& order,
+                   vector<int>& start) {
+    int n = slot.size();
+    vector<vector<int>> counts(parts, vector<int>(parts, 0));  // [thread][part]
+    parallelFor(parts, [&](int t) {
+        for (int i = (long long)n * t / parts; i < (long long)n * (t + 1) / parts; i++) {
+            counts[t][slotPart(slot[i], m, parts)]++;
+        }
+    });
+    // part by part, thread by thread, so each thread writes its own ranges
+    vector<vector<int>> offset(parts, vector<int>(parts));
+    start.assign(parts + 1, 0);
+    int pos = 0;
+    for (int p = 0; p < parts; p++) {
+        start[p] = pos;
+        for (int t = 0; t < parts; t++) {
+            offset[t][p] = pos;
+            pos += counts[t][p];
+        }
+    }
+    start[parts] = pos;
+    order.resize(n);
+    parallelFor(parts, [&](int t) {
+        for (int i = (long long)n * t / parts; i < (long long)n * (t + 1) / parts; i++) {
+            order[offset[t][slotPart(slot[i], m, parts)]++] = i;
+        }
+    });
+}
+
+// keys
+// the tables are templates over the key type: std::string, or a fixed-width key
+// where the characters are packed into 8 or 16 bytes, so that comparing two
+// keys is comparing one or two integers and a slot has no heap pointer in it
+template <int W>
+struct FixedKey {
+    static_assert(W == 8 || W == 16, "fixed keys are 8 or 16 bytes wide");
+    uint64_t w[W / 8];
+    FixedKey() {
+        for (int i = 0; i < W / 8; i++) w[i] = 0;
+    }
+    // explicit, so a string never turns into a key unnoticed (say in a timed
+    // call); a string longer than W can't be packed and is rejected
+    explicit FixedKey(const string& s) {
+        if (s.size() > W) throw length_error("key longer than FixedKey width");
+        for (int i = 0; i < W / 8; i++) w[i] = 0;
+        memcpy(w, s.data(), s.size());
+    }
+    bool operator==(const FixedKey& other) const {
+        for (int i = 0; i < W / 8; i++) {
+            if (w[i] != other.w[i]) return false;
+        }
+        return true;
+    }
+    string str() const { return string((const char*)w, strnlen((const char*)w, W)); }
+};
+
+template <int W>
+void __print(const FixedKey<W>& k) {
+    __print(k.str());
+}
+
+// the narrowest key that holds len characters, picked at compile time
+template <int len>
+using KeyFor = typename conditional<len <= 8, FixedKey<8>,
+                                    typename conditional<len <= 16, FixedKey<16>, string>::type>::type;
+typedef KeyFor<string_len> ShortKey;
+
+// the generated strings as keys of type K, converted once up front so that
+// no timed call pays for a string -> FixedKey conversion
+template <typename K>
+vector<K> asKeys(vector<string> strings) {
+    if constexpr (is_same<K, string>::value) return strings;
+    else return vector<K>(strings.begin(), strings.end());
+}
+
+// home slot hash and double hashing step for each key type
+inline unsigned long long keyHash(const string& s) { return primaryHash(s, MOD); }
+
+inline unsigned long long keyHash2(const string& s, int m) { return hash2(s, m); }
+
+template <int W>
+unsigned long long keyHash(const FixedKey<W>& k) {
+    uint64_t h = secret[0];
+    for (int i = 0; i < W / 8; i++) h = mum(k.w[i] ^ secret[1], h ^ secret[2 + i]);
+    return h;
+}
+
+template <int W>
+unsigned long long keyHash2(const FixedKey<W>& k, int m) {
+    return mum(keyHash(k) ^ secret[3], secret[0]) % (m - 1) + 1;
+}
+
+template <typename K>
+struct BasicPair {
    public:
-    string key;
+    K key;
     int value;
-    Pair* prev;
-    Pair* next;
-    Pair(const string& key, int value) : key(key), value(value) { prev = next = nullptr; }
+    BasicPair* prev;
+    BasicPair* next;
+    BasicPair(const K& key, int value) : key(key), value(value) { prev = next = nullptr; }
 };
 
-class SeparateChaining {
+typedef BasicPair<string> Pair;
+
+template <typename K>
+class BasicSeparateChaining {
    private:
+    typedef BasicPair<K> Pair;
     int m, size = 0;
     Pair** hashTable;
-    // using h1 as the hash function here
+    // using primaryHash as the hash function here
 
-    Pair* search_help(const string& s) {
-        int h = hash1(s) % m;
-        if (hashTable[h] == nullptr) {
-            // debug("head null for search", s);
-            return nullptr;
+    // incremental rehashing: while oldTable is not null, its nodes are moved
+    // into hashTable a few at a time on every insert/remove
+    Pair** oldTable = nullptr;
+    int oldM = 0, migrateIdx = 0;
+    double maxLoad;
+
+    vector<unsigned long long> batchHash;  // scratch space for the batch lookups
+
+    void pushFront(Pair** table, int h, Pair* node) {
+        node->prev = nullptr;
+        node->next = table[h];
+        if (table[h] != nullptr) table[h]->prev = node;
+        table[h] = node;
+    }
+
+    void unlink(Pair** table, int h, Pair* node) {
+        if (node == table[h]) {  // in head
+            table[h] = node->next;
+            if (table[h] != nullptr) table[h]->prev = nullptr;
+        } else {
+            Pair* after = node->next;
+            Pair* before = node->prev;
+            if (after != nullptr) after->prev = before;
+            before->next = after;  // as node is not head, so before is surely not null
         }
-        Pair* cur = hashTable[h];
+    }
+
+    Pair* findInBucket(Pair* cur, const K& s) {
         while (cur != nullptr) {
             if (cur->key == s) return cur;
             else cur = cur->next;
@@ -109,30 +409,128 @@ class SeparateChaining {
         return nullptr;
     }
 
+    // table and h are set to where the node was found
+    Pair* search_help(const K& s, unsigned long long hv, Pair**& table, int& h) {
+        table = hashTable;
+        h = hv % m;
+        Pair* ret = findInBucket(hashTable[h], s);
+        if (ret != nullptr || oldTable == nullptr) return ret;
+        table = oldTable;
+        h = hv % oldM;
+        return findInBucket(oldTable[h], s);
+    }
+
+    Pair* search_help(const K& s) {
+        Pair** table;
+        int h;
+        return search_help(s, keyHash(s), table, h);
+    }
+
+    // hashes the whole batch and prefetches every bucket slot, so the cache
+    // misses of different keys overlap; the first node's address is only known
+    // once its slot is loaded, so it is left to the lookup itself
+    void prefetch_batch(const K* keys, int n) {
+        batchHash.resize(n);
+        for (int i = 0; i < n; i++) {
+            batchHash[i] = keyHash(keys[i]);
+            __builtin_prefetch(&hashTable[batchHash[i] % m]);
+        }
+    }
+
+    void rehashStep(int work) {
+        while (oldTable != nullptr && work > 0) {
+            if (migrateIdx == oldM) {
+                delete[] oldTable;
+                oldTable = nullptr;
+                break;
+            }
+            Pair* node = oldTable[migrateIdx];
+            if (node == nullptr) migrateIdx++;
+            else {
+                unlink(oldTable, migrateIdx, node);
+                pushFront(hashTable, keyHash(node->key) % m, node);
+            }
+            work--;
+        }
+    }
+
+    // extra is how many keys are about to be added
+    void startRehash(int extra = 1) {
+        rehashStep(INT_MAX);  // the previous growth must be over first
+        oldTable = hashTable;
+        oldM = m;
+        migrateIdx = 0;
+        m = nextPrimeNumber(2 * m);
+        while (size + extra > maxLoad * m) m = nextPrimeNumber(2 * m);
+        hashTable = new Pair*[m];
+        for (int i = 0; i < m; i++) hashTable[i] = nullptr;
+        debug("separate chaining growing", oldM, m);
+    }
+
    public:
-    SeparateChaining(int m) {
+    BasicSeparateChaining(int m, double maxLoad = MAX_LOAD_CHAINING) {
         this->m = m;
+        this->maxLoad = maxLoad;
         hashTable = new Pair*[m];
         for (int i = 0; i < m; i++) hashTable[i] = nullptr;
     }
 
+    ~BasicSeparateChaining() {
+        rehashStep(INT_MAX);
+        for (int i = 0; i < m; i++) {
+            while (hashTable[i] != nullptr) {
+                Pair* next = hashTable[i]->next;
+                delete hashTable[i];
+                hashTable[i] = next;
+            }
+        }
+        delete[] hashTable;
+    }
+
     int getSize() { return size; }
 
-    bool search(const string& s) {
+    int getCapacity() { return m; }
+
+    double getLoadFactor() { return (double)size / m; }
+
+    bool isRehashing() { return oldTable != nullptr; }
+
+    bool search(const K& s) {
         Pair* ret = search_help(s);
         if (ret == nullptr) return false;
         else return true;
     }
 
-    int getValue(const string& s) {
+    int getValue(const K& s) {
         Pair* ret = search_help(s);
         if (ret == nullptr) return -1;  // not found
         else return ret->value;
     }
 
-    void insert(const string& s, int val) {
+    void search_batch(const K* keys, int n, bool* found) {
+        prefetch_batch(keys, n);
+        Pair** table;
+        int h;
+        for (int i = 0; i < n; i++) found[i] = search_help(keys[i], batchHash[i], table, h) != nullptr;
+    }
+
+    void get_batch(const K* keys, int n, int* values) {
+        prefetch_batch(keys, n);
+        Pair** table;
+        int h;
+        for (int i = 0; i < n; i++) {
+            Pair* ret = search_help(keys[i], batchHash[i], table, h);
+            values[i] = ret == nullptr ? -1 : ret->value;
+        }
+    }
+
+    void insert(const K& s, int val) {
+        rehashStep(REHASH_STEP);
         // first check if this string is already in the hash table
-        Pair* ret = search_help(s);
+        unsigned long long hv = keyHash(s);
+        Pair** table;
+        int h;
+        Pair* ret = search_help(s, hv, table, h);
         if (ret != nullptr) {
             debug("already present before insertion");
             // already present, so update the existing value
@@ -140,96 +538,288 @@ class SeparateChaining {
             return;
         }
 
-        int h = hash1(s) % m;
-        Pair* toBeInserted = new Pair(s, val);
-        if (hashTable[h] == nullptr) {
-            // debug("head null");
-            hashTable[h] = toBeInserted;
-        } else {
-            // debug("head not null");
-            toBeInserted->next = hashTable[h];
-            hashTable[h]->prev = toBeInserted;
-            hashTable[h] = toBeInserted;
-        }
+        if (size + 1 > maxLoad * m) startRehash();
+        pushFront(hashTable, hv % m, new Pair(s, val));
         // debug("insertion done", s);
         size++;
     }
 
-    void remove(const string& s) {
+    // inserts keys[i] with value getSize() + i + 1, the same as calling insert
+    // on each of them in turn (a repeated key keeps its last value)
+    // the keys are hashed in parallel and scattered by bucket range, then every
+    // thread fills its own range of buckets, so nothing needs a lock
+    void bulk_load(const vector<K>& keys, int threads = defaultThreads()) {
+        int n = keys.size();
+        // grown once, up front, to hold the keys already there and all of these
+        if (size + n > maxLoad * m) startRehash(n);
+        rehashStep(INT_MAX);
+        int base = size;
+        vector<int> slot(n);
+        parallelFor(threads, [&](int t) {
+            for (int i = (long long)n * t / threads; i < (long long)n * (t + 1) / threads; i++) {
+                slot[i] = keyHash(keys[i]) % m;
+            }
+        });
+        vector<int> order, start;
+        scatterBySlot(slot, m, threads, order, start);
+        vector<int> added(threads, 0);
+        parallelFor(threads, [&](int t) {
+            for (int j = start[t]; j < start[t + 1]; j++) {
+                int i = order[j];
+                Pair* ret = findInBucket(hashTable[slot[i]], keys[i]);
+                if (ret != nullptr) ret->value = base + i + 1;
+                else {
+                    pushFront(hashTable, slot[i], new Pair(keys[i], base + i + 1));
+                    added[t]++;
+                }
+            }
+        });
+        for (int a : added) size += a;
+    }
+
+    void remove(const K& s) {
+        rehashStep(REHASH_STEP);
         // debug("deletion started", s);
-        Pair* ret = search_help(s);
+        Pair** table;
+        int h;
+        Pair* ret = search_help(s, keyHash(s), table, h);
         if (ret == nullptr) {
             debug("not present to delete for separate chaining");
             return;  // not present
         }
-
-        int h = hash1(s) % m;
-        if (ret == hashTable[h]) {  // in head
-            hashTable[h] = ret->next;
-            if (hashTable[h] != nullptr) hashTable[h]->prev = nullptr;
-        } else {
-            Pair* after = ret->next;
-            Pair* before = ret->prev;
-            if (after != nullptr) after->prev = before;
-            before->next = after;  // as ret is not head, so before is surely not null
-        }
+        unlink(table, h, ret);
         // debug("deletion done", s);
         delete ret;
+        size--;
     }
 };
 
-struct Pair2 {
+typedef BasicSeparateChaining<string> SeparateChaining;
+
+template <typename K>
+struct BasicPair2 {
    public:
-    string key;
+    K key;
     int value;
-    Pair2() : key(""), value(-1) {}
-    Pair2(const string& key, int value) : key(key), value(value) {}
+    BasicPair2() : key(), value(-1) {}
+    BasicPair2(const K& key, int value) : key(key), value(value) {}
 };
 
+typedef BasicPair2<string> Pair2;
+
 enum resolutionMethod { LinearProbing, QuadraticProbing, DoubleHashing };
 
-class Probing {
+// i-th slot of the probe sequence, given home = hash % m and
+// step = hash2 (only used for double hashing)
+inline int probeIndex(resolutionMethod p, unsigned long long home, unsigned long long step, int i,
+                      int m) {
+    if (p == LinearProbing) return (home + i) % m;
+    else if (p == QuadraticProbing) return (home + c1 * i + c2 * i * 1LL * i) % m;
+    else return (home + step * i) % m;
+}
+
+template <typename K>
+class BasicProbing {
    private:
-    int m, size;
+    typedef BasicPair2<K> Pair2;
+    int m, size = 0;
+    int used = 0;  // slots of hashTable that are not empty, tombstones included
     Pair2* hashTable;
-    resolutionMethod p;
+    resolutionMethod p = LinearProbing;
     bool* deleted;
 
-    int hash(const string& s, int i) {
-        if (p == LinearProbing) return (hash1(s) + i) % m;
-        else if (p == QuadraticProbing) return (hash1(s) + c1 * i + c2 * i * 1LL * i) % m;
-        else return (hash1(s) + hash2(s, m) * i) % m;
+    // incremental rehashing: while oldTable is not null, its slots are moved
+    // into hashTable a few at a time on every insert/remove
+    // moved slots become tombstones, so searches in the old table still work
+    Pair2* oldTable = nullptr;
+    bool* oldDeleted = nullptr;
+    int oldM = 0, migrateIdx = 0;
+    double maxLoad;
+
+    vector<unsigned long long> batchHash;  // scratch space for the batch lookups
+
+    // home and step are worked out once per operation
+    int hash(unsigned long long home, unsigned long long step, int i, int m) {
+        return probeIndex(p, home, step, i, m);
+    }
+
+    unsigned long long stepHash(const K& s, int m) {
+        return p == DoubleHashing ? keyHash2(s, m) : 0;
     }
 
-    int search_help(const string& s, int& probe) {
+    int search_in(Pair2* table, bool* del, int m, const K& s, unsigned long long hv,
+                  int& probe) {
         // returns the found index, else -1
+        unsigned long long home = hv % m, step = stepHash(s, m);
         probe = 0;
         while (probe < m) {
-            int idx = hash(s, probe);
-            if (hashTable[idx].key == s) return idx;
-            else if (!deleted[idx] && hashTable[idx].value == -1) return -1;
+            int idx = hash(home, step, probe, m);
+            if (table[idx].key == s) return idx;
+            else if (!del[idx] && table[idx].value == -1) return -1;
             probe++;
         }
         return -1;
     }
 
+    int search_help(const K& s, unsigned long long hv, int& probe, bool& inOld) {
+        inOld = false;
+        int ret = search_in(hashTable, deleted, m, s, hv, probe);
+        if (ret != -1 || oldTable == nullptr) return ret;
+        int oldProbe = 0;
+        ret = search_in(oldTable, oldDeleted, oldM, s, hv, oldProbe);
+        probe += oldProbe + 1;
+        inOld = ret != -1;
+        return ret;
+    }
+
+    int search_help(const K& s, int& probe, bool& inOld) {
+        return search_help(s, keyHash(s), probe, inOld);
+    }
+
+    int search_help(const K& s, int& probe) {
+        bool inOld;
+        return search_help(s, probe, inOld);
+    }
+
+    // hashes the whole batch and prefetches every home slot first,
+    // so the cache misses of different keys overlap
+    void prefetch_batch(const K* keys, int n) {
+        batchHash.resize(n);
+        for (int i = 0; i < n; i++) {
+            batchHash[i] = keyHash(keys[i]);
+            int home = batchHash[i] % m;
+            __builtin_prefetch(&hashTable[home]);
+            __builtin_prefetch(&deleted[home]);
+        }
+    }
+
+    // puts the key (hv = keyHash(s)) in the first free slot of hashTable,
+    // returns -1 if none; the key is only copied (or moved, when given an
+    // rvalue) into the slot it ends up in
+    template <typename Key>
+    int place(Key&& s, unsigned long long hv, int val) {
+        unsigned long long home = hv % m, step = stepHash(s, m);
+        for (int i = 0; i < m; i++) {
+            int j = hash(home, step, i, m);
+            if (hashTable[j].value == -1) {
+                if (!deleted[j]) used++;
+                hashTable[j].key = forward<Key>(s);
+                hashTable[j].value = val;
+                deleted[j] = false;
+                return j;
+            }
+        }
+        return -1;
+    }
+
+    void rehashStep(int work) {
+        while (oldTable != nullptr && work > 0) {
+            if (migrateIdx == oldM) {
+                delete[] oldTable;
+                delete[] oldDeleted;
+                oldTable = nullptr;
+                oldDeleted = nullptr;
+                break;
+            }
+            Pair2& slot = oldTable[migrateIdx];
+            if (slot.value != -1) {
+                unsigned long long hv = keyHash(slot.key);
+                while (place(move(slot.key), hv, slot.value) == -1) enlarge();
+                slot.key = K();
+                slot.value = -1;
+                oldDeleted[migrateIdx] = true;
+            }
+            migrateIdx++;
+            work--;
+        }
+    }
+
+    // the new table has no slot left on some probe sequence (quadratic probing
+    // in a table whose size isn't prime reaches only part of it): moves what
+    // it holds so far into one at least twice as big, with a prime size
+    void enlarge() {
+        Pair2* cur = hashTable;
+        bool* curDeleted = deleted;
+        int curM = m;
+        m = nextPrimeNumber(2 * m);
+        used = 0;
+        hashTable = new Pair2[m];
+        deleted = new bool[m];
+        for (int i = 0; i < m; i++) deleted[i] = false;
+        debug("probing enlarging", to_string(p), curM, m);
+        for (int i = 0; i < curM; i++) {
+            if (cur[i].value != -1) {
+                bool placed = place(move(cur[i].key), keyHash(cur[i].key), cur[i].value) != -1;
+                assert(placed);  // prime size, at most half full
+                (void)placed;
+            }
+        }
+        delete[] cur;
+        delete[] curDeleted;
+    }
+
+    // extra is how many keys are about to be added
+    // the new table is allocated and cleared here in one go, so the insert
+    // that starts a growth pays O(m) for it; only moving the keys is spread
+    // over the later operations
+    void startRehash(int extra = 1) {
+        rehashStep(INT_MAX);  // the previous growth must be over first
+        oldTable = hashTable;
+        oldDeleted = deleted;
+        oldM = m;
+        migrateIdx = 0;
+        // mostly tombstones: rebuilding at the same size is enough
+        if (size + extra > maxLoad * m / 2) m = nextPrimeNumber(2 * m);
+        // a bulk load may need more than one doubling
+        while (size + extra > maxLoad * m) m = nextPrimeNumber(2 * m);
+        used = 0;
+        hashTable = new Pair2[m];
+        deleted = new bool[m];
+        for (int i = 0; i < m; i++) deleted[i] = false;
+        debug("probing growing", to_string(p), oldM, m);
+    }
+
    public:
     void setProbingMethod(resolutionMethod p) { this->p = p; }
 
-    Probing(int m) {
+    resolutionMethod getProbingMethod() { return p; }
+
+    BasicProbing(int m, double maxLoad = MAX_LOAD_PROBING) {
         this->m = m;
+        this->maxLoad = maxLoad;
         hashTable = new Pair2[m];
         deleted = new bool[m];
         for (int i = 0; i < m; i++) {
             deleted[i] = false;
-            hashTable[i].key = "";
+            hashTable[i].key = K();
             hashTable[i].value = -1;
         }
     }
 
+    ~BasicProbing() {
+        delete[] hashTable;
+        delete[] deleted;
+        delete[] oldTable;
+        delete[] oldDeleted;
+    }
+
     int getSize() { return size; }
 
-    bool search(const string& s, int& p) {
+    int getCapacity() { return m; }
+
+    double getLoadFactor() { return (double)size / m; }
+
+    bool isRehashing() { return oldTable != nullptr; }
+
+    // f(idx, key, value, deleted) for every slot, in order
+    // any growth in progress is finished first, so there is a single table
+    template <typename F>
+    void forEachSlot(F f) {
+        rehashStep(INT_MAX);
+        for (int i = 0; i < m; i++) f(i, hashTable[i].key, hashTable[i].value, deleted[i]);
+    }
+
+    bool search(const K& s, int& p) {
         int pr = 0;
         int ret = search_help(s, pr);
         pr++;  // started from 0 there
@@ -238,50 +828,126 @@ class Probing {
         else return true;
     }
 
-    int getValue(const string& s) {
+    int getValue(const K& s) {
         int pr = 0;
-        int ret = search_help(s, pr);
+        bool inOld;
+        int ret = search_help(s, pr, inOld);
         if (ret == -1) return -1;
-        else return hashTable[ret].value;
+        else return inOld ? oldTable[ret].value : hashTable[ret].value;
+    }
+
+    void search_batch(const K* keys, int n, bool* found) {
+        prefetch_batch(keys, n);
+        int pr;
+        bool inOld;
+        for (int i = 0; i < n; i++) found[i] = search_help(keys[i], batchHash[i], pr, inOld) != -1;
+    }
+
+    void get_batch(const K* keys, int n, int* values) {
+        prefetch_batch(keys, n);
+        int pr;
+        bool inOld;
+        for (int i = 0; i < n; i++) {
+            int ret = search_help(keys[i], batchHash[i], pr, inOld);
+            if (ret == -1) values[i] = -1;
+            else values[i] = inOld ? oldTable[ret].value : hashTable[ret].value;
+        }
     }
 
-    void insert(const string& s, int val) {
+    void insert(const K& s, int val) {
+        rehashStep(REHASH_STEP);
         int temp = 0;
-        int ret = search_help(s, temp);
+        bool inOld;
+        unsigned long long hv = keyHash(s);
+        int ret = search_help(s, hv, temp, inOld);
         if (ret != -1) {  // already present
                           // so we have to update the existing value
             debug("already present before insertion");
-            hashTable[ret].value = val;
-            deleted[ret] = true;
+            (inOld ? oldTable : hashTable)[ret].value = val;
             return;
         }
 
-        int i = 0;
-        int j;
-        while (i < m) {
-            j = hash(s, i);
-            if (hashTable[j].value == -1) {
-                hashTable[j].key = s;
-                hashTable[j].value = val;
-                deleted[j] = false;
-                size++;
-                break;
-            } else i++;
+        if (used + 1 > maxLoad * m) startRehash();
+        if (place(s, hv, val) == -1) {
+            // probe sequence ran out of free slots (quadratic probing can),
+            // so grow now instead of giving up
+            startRehash();
+            while (place(s, hv, val) == -1) enlarge();
+        }
+        size++;
+    }
+
+    // inserts keys[i] with value getSize() + i + 1, the same as calling insert
+    // on each of them in turn (a repeated key keeps its last value)
+    // the keys are hashed in parallel and scattered by slot range, and every
+    // thread follows the probe sequences of its keys inside its own range only;
+    // a key whose sequence leaves the range before finding a free slot is put
+    // in afterwards with a plain insert, so nothing needs a lock
+    void bulk_load(const vector<K>& keys, int threads = defaultThreads()) {
+        int n = keys.size();
+        // grown once, up front, to hold the keys already there and all of these
+        if (used + n > maxLoad * m) startRehash(n);
+        rehashStep(INT_MAX);
+        int base = size;
+        vector<int> slot(n);
+        parallelFor(threads, [&](int t) {
+            for (int i = (long long)n * t / threads; i < (long long)n * (t + 1) / threads; i++) {
+                slot[i] = keyHash(keys[i]) % m;
+            }
+        });
+        vector<int> order, start;
+        scatterBySlot(slot, m, threads, order, start);
+        vector<int> added(threads, 0);
+        vector<vector<int>> deferred(threads);
+        parallelFor(threads, [&](int t) {
+            for (int j = start[t]; j < start[t + 1]; j++) {
+                int i = order[j];
+                unsigned long long step = stepHash(keys[i], m);
+                bool done = false;
+                for (int pr = 0; pr < m && !done; pr++) {
+                    int idx = hash(slot[i], step, pr, m);
+                    if (slotPart(idx, m, threads) != t) break;  // another thread's slots
+                    if (hashTable[idx].value != -1) {
+                        if (hashTable[idx].key == keys[i]) {
+                            hashTable[idx].value = base + i + 1;
+                            done = true;
+                        }
+                    } else if (!deleted[idx]) {
+                        hashTable[idx].key = keys[i];
+                        hashTable[idx].value = base + i + 1;
+                        added[t]++;
+                        done = true;
+                    }
+                    // tombstones are walked past, the plain insert may reuse them
+                }
+                if (!done) deferred[t].push_back(i);
+            }
+        });
+        for (int a : added) {
+            size += a;
+            used += a;
         }
-        if (i == m) {
-            debug("can't insert", to_string(p), s, j);
+        for (int t = 0; t < threads; t++) {
+            for (int i : deferred[t]) insert(keys[i], base + i + 1);
         }
     }
 
-    void remove(const string& s) {
+    void remove(const K& s) {
+        rehashStep(REHASH_STEP);
         int temp = 0;
-        int ret = search(s, temp);
+        bool inOld;
+        int ret = search_help(s, temp, inOld);
         if (ret == -1) {
             debug("not present to delete for probing", to_string(p));
             return;  // not present
         }
-        hashTable[ret].key = "";
-        hashTable[ret].value = -1;
-        deleted[ret] = true;
+        Pair2* table = inOld ? oldTable : hashTable;
+        bool* del = inOld ? oldDeleted : deleted;
+        table[ret].key = K();
+        table[ret].value = -1;
+        del[ret] = true;
+        size--;
     }
-};
\ No newline at end of file
+};
+
+typedef BasicProbing<string> Probing;
\ No newline at end of file
@@ -4,13 +4,99 @@
 #include <iomanip>
 #include <iostream>
 #include <numeric>
+#include <random>
+#include <thread>
 #include <vector>
 
+#include "ConcurrentHashing.h"
+#include "Cuckoo.h"
+#include "GroupProbing.h"
+#include "RobinHood.h"
+#include "SlabChaining.h"
+#include "Snapshot.h"
+#include "Workload.h"
 #include "hashing.h"
 using namespace std;
 
 int N;                // guaranteed to be a prime (1000003)
-double res[5][7][4];  // resolution method (in order), load factor, values
+double res[10][7][6];  // resolution method (in order), load factor, values
+
+// one load factor's worth of insertion, search, deletion and search again
+// on a chaining table keyed by K; results go to res[id][idx]
+template <typename K = string, typename Table>
+void chainTable(Table& sc, int id, int idx, double lf) {
+    cout << lf << ": ";
+    int needed = lf * N;
+    vector<bool> del(needed, false);
+    vector<int> deleted, not_deleted;
+
+    // generation
+    vector<K> strings = asKeys<K>(generate_strings(needed, string_len));
+    debug("generation done", lf, needed);
+
+    // insertion
+    for (auto& s : strings) {
+        bool ret = sc.search(s);
+        if (!ret) sc.insert(s, sc.getSize() + 1);
+        else {
+            debug("Already present before insertion");
+        }
+    }
+    // debug("insertion done", lf);
+
+    vector<int> random_vector(needed);
+    iota(random_vector.begin(), random_vector.end(), 0);
+
+    // search before deletion
+    int p = 0.1 * needed;
+    if (p & 1) p++;
+    double tot_time = 0;  // in ms
+    auto start = chrono::high_resolution_clock::now();
+    random_shuffle(random_vector.begin(), random_vector.end());
+    for (int i = 1; i <= p; i++) {
+        int index = random_vector[i - 1];
+        start = chrono::high_resolution_clock::now();
+        bool p = sc.search(strings[index]);
+        tot_time += chrono::duration_cast<chrono::nanoseconds>(
+                        chrono::high_resolution_clock::now() - start)
+                        .count() /
+                    1000000.0;
+    }
+    res[id][idx][0] = tot_time / p;
+    cout << tot_time / p << "ms              N/A               ";
+
+    // deletion
+    random_shuffle(random_vector.begin(), random_vector.end());
+    for (int i = 1; i <= p; i++) {
+        int index = random_vector[i - 1];
+        sc.remove(strings[index]);
+        del[index] = true;
+    }
+    for (int i = 0; i < needed; i++) {
+        if (del[i]) deleted.push_back(i);
+        else not_deleted.push_back(i);
+    }
+    // debug("deletion done", lf);
+
+    // search after deletion
+    random_shuffle(deleted.begin(), deleted.end());
+    random_shuffle(not_deleted.begin(), not_deleted.end());
+    tot_time = 0;
+    for (int i = 1; i <= p; i++) {
+        int index;
+        if (i & 1) index = deleted[i / 2];    // from deleted elements
+        else index = not_deleted[i / 2 - 1];  // from non-deleted items
+        start = chrono::high_resolution_clock::now();
+        bool p = sc.search(strings[index]);
+        tot_time += chrono::duration_cast<chrono::nanoseconds>(
+                        chrono::high_resolution_clock::now() - start)
+                        .count() /
+                    1000000.0;
+    }
+    res[id][idx][2] = tot_time / p;
+    cout << tot_time / p << "ms           N/A";
+    cout << "\n";
+}
 
 void doSeparateChaining() {
     // separate chaining
@@ -20,82 +106,118 @@ void doSeparateChaining() {
             "Deletion     Probes\n";
     int idx = 0;
     for (double lf = 0.4; lf <= 0.9; lf += 0.1, idx++) {
-        auto start = chrono::high_resolution_clock::now();
         SeparateChaining sc(N);
-        cout << lf << ": ";
-        int needed = lf * N;
-        vector<bool> del(needed, false);
-        vector<int> deleted, not_deleted;
-
-        // generation
-        vector<string> strings = generate_strings(needed, string_len);
-        debug("generation done", lf, needed);
-
-        // insertion
-        for (auto& s : strings) {
-            bool ret = sc.search(s);
-            if (!ret) sc.insert(s, sc.getSize() + 1);
-            else {
-                debug("Already present before insertion");
-            }
-        }
-        // debug("insertion done", lf);
-
-        vector<int> random_vector(needed);
-        iota(random_vector.begin(), random_vector.end(), 0);
-
-        // search before deletion
-        int p = 0.1 * needed;
-        if (p & 1) p++;
-        double tot_time = 0;  // in ms
-        random_shuffle(random_vector.begin(), random_vector.end());
-        for (int i = 1; i <= p; i++) {
-            int index = random_vector[i - 1];
-            start = chrono::high_resolution_clock::now();
-            bool p = sc.search(strings[index]);
-            tot_time += chrono::duration_cast<chrono::nanoseconds>(
-                            chrono::high_resolution_clock::now() - start)
-                            .count() /
-                        1000000.0;
-        }
-        res[0][idx][0] = tot_time / p;
-        cout << tot_time / p << "ms              N/A               ";
-
-        // deletion
-        random_shuffle(random_vector.begin(), random_vector.end());
-        for (int i = 1; i <= p; i++) {
-            int index = random_vector[i - 1];
-            sc.remove(strings[index]);
-            del[index] = true;
-        }
-        for (int i = 0; i < needed; i++) {
-            if (del[i]) deleted.push_back(i);
-            else not_deleted.push_back(i);
-        }
-        // debug("deletion done", lf);
-
-        // search after deletion
-        random_shuffle(deleted.begin(), deleted.end());
-        random_shuffle(not_deleted.begin(), not_deleted.end());
-        tot_time = 0;
-        for (int i = 1; i <= p; i++) {
-            int index;
-            if (i & 1) index = deleted[i / 2];    // from deleted elements
-            else index = not_deleted[i / 2 - 1];  // from non-deleted items
-            start = chrono::high_resolution_clock::now();
-            bool p = sc.search(strings[index]);
-            tot_time += chrono::duration_cast<chrono::nanoseconds>(
-                            chrono::high_resolution_clock::now() - start)
-                            .count() /
-                        1000000.0;
-        }
-        res[0][idx][2] = tot_time / p;
-        cout << tot_time / p << "ms           N/A";
-        cout << "\n";
+        chainTable(sc, 0, idx, lf);
     }
     cout << "\n\n";
 }
 
+void doSlabChaining() {
+    // same as separate chaining, but the entries are kept in one slab
+    cout << "Slab Chaining:\n";
+    cout << "Load Factor: Time Before Deletion       Probes            Time "
+            "After "
+            "Deletion     Probes\n";
+    int idx = 0;
+    for (double lf = 0.4; lf <= 0.9; lf += 0.1, idx++) {
+        SlabChaining sc(N);
+        chainTable(sc, 5, idx, lf);
+    }
+    cout << "\n\n";
+}
+
+// one load factor's worth of insertion, search, deletion and search again
+// on an open addressing table keyed by K; results go to res[id2][idx]
+template <typename K = string, typename Table>
+void probeTable(Table& lp, int id2, int idx, double lf) {
+    ll probes, probes2;  // sum of probe counts and of their squares
+    cout << lf << ": ";
+    int needed = lf * N;
+    vector<bool> del(needed, false);
+    vector<int> deleted, not_deleted;
+
+    // generation
+    vector<K> strings = asKeys<K>(generate_strings(needed, string_len));
+    debug("generation done", lf, needed);
+
+    // insertion
+    for (auto& s : strings) {
+        int tmp = 0;
+        bool ret = lp.search(s, tmp);
+        if (!ret) lp.insert(s, lp.getSize() + 1);
+        else {
+            debug("Already present before insertion");
+        }
+    }
+    // debug("insertion done", lf);
+
+    vector<int> random_vector(needed);
+    iota(random_vector.begin(), random_vector.end(), 0);
+
+    // search before deletion
+    int p = 0.1 * needed;
+    if (p & 1) p++;
+    double tot_time = 0;  // in micro seconds
+    probes = probes2 = 0;
+    auto start = chrono::high_resolution_clock::now();
+    random_shuffle(random_vector.begin(), random_vector.end());
+    for (int i = 1; i <= p; i++) {
+        int index = random_vector[i - 1];
+        int pp = 0;
+        start = chrono::high_resolution_clock::now();
+        bool p = lp.search(strings[index], pp);
+        tot_time += chrono::duration_cast<chrono::nanoseconds>(
+                        chrono::high_resolution_clock::now() - start)
+                        .count() /
+                    1000000.0;
+        probes += pp;
+        probes2 += pp * 1LL * pp;
+    }
+    res[id2][idx][0] = tot_time / p;
+    res[id2][idx][1] = (double)probes / p;
+    res[id2][idx][4] = (double)probes2 / p - res[id2][idx][1] * res[id2][idx][1];
+    cout << tot_time / p << "ms              " << (double)probes / p << "       ";
+
+    // deletion
+    random_shuffle(random_vector.begin(), random_vector.end());
+    for (int i = 1; i <= p; i++) {
+        int index = random_vector[i - 1];
+        lp.remove(strings[index]);
+        del[index] = true;
+    }
+    for (int i = 0; i < needed; i++) {
+        if (del[i]) deleted.push_back(i);
+        else not_deleted.push_back(i);
+    }
+    // debug("deletion done", lf);
+
+    // search after deletion
+    tot_time = 0;
+    probes = probes2 = 0;
+    random_shuffle(deleted.begin(), deleted.end());
+    random_shuffle(not_deleted.begin(), not_deleted.end());
+    for (int i = 1; i <= p; i++) {
+        int index;
+        if (i & 1) index = deleted[i / 2];    // from deleted elements
+        else index = not_deleted[i / 2 - 1];  // from non-deleted items
+        int pp = 0;
+        start = chrono::high_resolution_clock::now();
+        bool p = lp.search(strings[index], pp);
+        tot_time += chrono::duration_cast<chrono::nanoseconds>(
+                        chrono::high_resolution_clock::now() - start)
+                        .count() /
+                    1000000.0;
+        probes += pp;
+        probes2 += pp * 1LL * pp;
+    }
+    res[id2][idx][2] = tot_time / p;
+    res[id2][idx][3] = (double)probes / p;
+    res[id2][idx][5] = (double)probes2 / p - res[id2][idx][3] * res[id2][idx][3];
+    cout << tot_time / p << "ms           " << (double)probes / p << "        ";
+    cout << res[id2][idx][4] << "         " << res[id2][idx][5];
+    cout << "\n";
+}
+
 void doProbing(resolutionMethod p) {
     // probing
     int id2;
@@ -111,94 +233,296 @@ void doProbing(resolutionMethod p) {
     }
     cout << "Load Factor: Time Before Deletion       Probes            Time "
             "After "
-            "Deletion     Probes\n";
-    auto start = chrono::high_resolution_clock::now();
+            "Deletion     Probes             Variance Before     Variance After\n";
     int idx = 0;
     for (double lf = 0.4; lf <= 0.9; lf += 0.1, idx++) {
         Probing lp(N);
         lp.setProbingMethod(p);
-        ll probes;
-        cout << lf << ": ";
-        int needed = lf * N;
-        vector<bool> del(needed, false);
-        vector<int> deleted, not_deleted;
-
-        // generation
-        vector<string> strings = generate_strings(needed, string_len);
-        debug("generation done", lf, needed);
-
-        // insertion
-        for (auto& s : strings) {
-            int tmp = 0;
-            bool ret = lp.search(s, tmp);
-            if (!ret) lp.insert(s, lp.getSize() + 1);
-            else {
-                debug("Already present before insertion");
-            }
-        }
-        // debug("insertion done", lf);
-
-        vector<int> random_vector(needed);
-        iota(random_vector.begin(), random_vector.end(), 0);
-
-        // search before deletion
-        int p = 0.1 * needed;
-        if (p & 1) p++;
-        double tot_time = 0;  // in micro seconds
-        probes = 0;
-        random_shuffle(random_vector.begin(), random_vector.end());
-        for (int i = 1; i <= p; i++) {
-            int index = random_vector[i - 1];
-            int pp = 0;
-            start = chrono::high_resolution_clock::now();
-            bool p = lp.search(strings[index], pp);
-            tot_time += chrono::duration_cast<chrono::nanoseconds>(
+        probeTable(lp, id2, idx, lf);
+    }
+    cout << "\n\n";
+}
+
+void doRobinHood() {
+    cout << "Robin Hood Probing\n";
+    cout << "Load Factor: Time Before Deletion       Probes            Time "
+            "After "
+            "Deletion     Probes             Variance Before     Variance After\n";
+    int idx = 0;
+    for (double lf = 0.4; lf <= 0.9; lf += 0.1, idx++) {
+        RobinHoodProbing rh(N);
+        probeTable(rh, 6, idx, lf);
+    }
+    cout << "\n\n";
+}
+
+void doCuckoo() {
+    // probes here are the number of buckets looked at (2 at most, 3 with the stash)
+    cout << "Cuckoo Hashing (4-way buckets)\n";
+    cout << "Load Factor: Time Before Deletion       Probes            Time "
+            "After "
+            "Deletion     Probes             Variance Before     Variance After\n";
+    int idx = 0;
+    for (double lf = 0.4; lf <= 0.9; lf += 0.1, idx++) {
+        CuckooHashing ch(N);
+        probeTable(ch, 7, idx, lf);
+    }
+    cout << "\n\n";
+}
+
+// the same separate chaining and linear probing tables, with the keys packed
+// into a ShortKey (8 bytes for string_len = 7) instead of a std::string
+void doShortKeys() {
+    cout << "Short keys: " << sizeof(ShortKey) << " byte keys, " << sizeof(BasicPair2<ShortKey>)
+         << " byte slots (std::string: " << sizeof(Pair2) << "), "
+         << sizeof(BasicPair<ShortKey>) << " byte chain nodes (std::string: " << sizeof(Pair)
+         << ")\n";
+    cout << "Separate Chaining (short keys):\n";
+    cout << "Load Factor: Time Before Deletion       Probes            Time "
+            "After "
+            "Deletion     Probes\n";
+    int idx = 0;
+    for (double lf = 0.4; lf <= 0.9; lf += 0.1, idx++) {
+        BasicSeparateChaining<ShortKey> sc(N);
+        chainTable<ShortKey>(sc, 8, idx, lf);
+    }
+    cout << "\n\n";
+    cout << "Linear Probing (short keys):\n";
+    cout << "Load Factor: Time Before Deletion       Probes            Time "
+            "After "
+            "Deletion     Probes             Variance Before     Variance After\n";
+    idx = 0;
+    for (double lf = 0.4; lf <= 0.9; lf += 0.1, idx++) {
+        BasicProbing<ShortKey> lp(N);
+        lp.setProbingMethod(LinearProbing);
+        probeTable<ShortKey>(lp, 9, idx, lf);
+    }
+    cout << "\n\n";
+}
+
+void doGroupProbing() {
+    // probes here are the number of 16-slot groups looked at
+    cout << "Group Probing (SIMD)\n";
+    cout << "Load Factor: Time Before Deletion       Probes            Time "
+            "After "
+            "Deletion     Probes             Variance Before     Variance After\n";
+    int idx = 0;
+    for (double lf = 0.4; lf <= 0.9; lf += 0.1, idx++) {
+        GroupProbing gp(N);
+        probeTable(gp, 4, idx, lf);
+    }
+    cout << "\n\n";
+}
+
+// tables start small and grow to N keys with incremental rehashing
+// the tail of the insert latency shows whether a resize is ever paid in one go
+template <typename Table>
+void growTable(Table& table, const vector<string>& strings, const string& name) {
+    vector<double> times;  // in ms
+    times.reserve(strings.size());
+    for (auto& s : strings) {
+        auto start = chrono::high_resolution_clock::now();
+        table.insert(s, table.getSize() + 1);
+        times.push_back(chrono::duration_cast<chrono::nanoseconds>(
                             chrono::high_resolution_clock::now() - start)
                             .count() /
-                        1000000.0;
-            probes += pp;
-        }
-        res[id2][idx][0] = tot_time / p;
-        res[id2][idx][1] = (double)probes / p;
-        cout << tot_time / p << "ms              " << (double)probes / p << "       ";
-
-        // deletion
-        random_shuffle(random_vector.begin(), random_vector.end());
-        for (int i = 1; i <= p; i++) {
-            int index = random_vector[i - 1];
-            lp.remove(strings[index]);
-            del[index] = true;
-        }
-        for (int i = 0; i < needed; i++) {
-            if (del[i]) deleted.push_back(i);
-            else not_deleted.push_back(i);
+                        1000000.0);
+    }
+    double mean = accumulate(times.begin(), times.end(), 0.0) / times.size();
+    sort(times.begin(), times.end());
+    cout << name << mean << "ms     " << times[times.size() * 99 / 100] << "ms     "
+         << times.back() << "ms     " << table.getCapacity() << "\n";
+}
+
+void doGrowth() {
+    const int initial = 10007;
+    cout << "Growth from " << initial << " to " << N << " keys:\n";
+    cout << "Method:            Mean Insert     p99 Insert      Max Insert      Final Capacity\n";
+    vector<string> strings = generate_strings(N, string_len);
+    SeparateChaining sc(initial);
+    growTable(sc, strings, "Separate Chaining: ");
+    Probing lp(initial);
+    lp.setProbingMethod(LinearProbing);
+    growTable(lp, strings, "Linear Probing:    ");
+    cout << "\n\n";
+}
+
+// aggregate throughput of the sharded map as threads are added
+// half of the keys are loaded up front, then every thread runs a mix of
+// 90% searches, 5% inserts and 5% removes over random keys
+void doConcurrent() {
+    const int total_ops = 4000000;
+    cout << "Sharded map, 90% search / 5% insert / 5% remove:\n";
+    cout << "Threads:   Time              Ops/sec\n";
+    vector<string> strings = generate_strings(N, string_len);
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        ShardedHashMap map(N);
+        for (int i = 0; i < N / 2; i++) map.insert(strings[i], i + 1);
+
+        int per_thread = total_ops / threads;
+        vector<thread> workers;
+        auto start = chrono::high_resolution_clock::now();
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&, t]() {
+                mt19937 rng(t + 1);  // rand() is not thread safe
+                uniform_int_distribution<int> pick(0, N - 1), op(0, 99);
+                for (int i = 0; i < per_thread; i++) {
+                    const string& s = strings[pick(rng)];
+                    int o = op(rng);
+                    if (o < 90) map.search(s);
+                    else if (o < 95) map.insert(s, i);
+                    else map.remove(s);
+                }
+            });
         }
-        // debug("deletion done", lf);
-
-        // search after deletion
-        tot_time = 0;
-        probes = 0;
-        random_shuffle(deleted.begin(), deleted.end());
-        random_shuffle(not_deleted.begin(), not_deleted.end());
-        for (int i = 1; i <= p; i++) {
-            int index;
-            if (i & 1) index = deleted[i / 2];    // from deleted elements
-            else index = not_deleted[i / 2 - 1];  // from non-deleted items
-            int pp = 0;
-            start = chrono::high_resolution_clock::now();
-            bool p = lp.search(strings[index], pp);
-            tot_time += chrono::duration_cast<chrono::nanoseconds>(
+        for (auto& w : workers) w.join();
+        double secs = chrono::duration_cast<chrono::nanoseconds>(
+                          chrono::high_resolution_clock::now() - start)
+                          .count() /
+                      1e9;
+        cout << threads << ":         " << secs * 1000 << "ms     "
+             << (double)per_thread * threads / secs << "\n";
+        cerr << threads << " threads done\n";
+    }
+    cout << "\n\n";
+}
+
+// lookups of 10% of the keys, issued in batches of the given size
+// returns the time per key in ms
+template <typename Table>
+double timeBatches(Table& table, const vector<string>& queries, int batch) {
+    vector<int> values(batch);
+    auto start = chrono::high_resolution_clock::now();
+    for (int i = 0; i + batch <= (int)queries.size(); i += batch) {
+        table.get_batch(&queries[i], batch, values.data());
+    }
+    return chrono::duration_cast<chrono::nanoseconds>(
+               chrono::high_resolution_clock::now() - start)
+               .count() /
+           1000000.0 / (queries.size() / batch * batch);
+}
+
+void doBatch() {
+    const int batches[] = {1, 8, 32, 128};
+    double lf = 0.8;
+    int needed = lf * N;
+    cout << "Batch lookups at load factor " << lf << ", time per key:\n";
+    cout << "Method:            Batch 1           Batch 8           Batch 32          Batch 128\n";
+    vector<string> strings = generate_strings(needed, string_len);
+    vector<string> queries(strings.begin(), strings.begin() + needed / 10);
+    random_shuffle(queries.begin(), queries.end());
+
+    SeparateChaining sc(N);
+    Probing lp(N);
+    lp.setProbingMethod(LinearProbing);
+    for (auto& s : strings) {
+        sc.insert(s, sc.getSize() + 1);
+        lp.insert(s, lp.getSize() + 1);
+    }
+    cout << "Separate Chaining: ";
+    for (int b : batches) cout << timeBatches(sc, queries, b) << "ms     ";
+    cout << "\nLinear Probing:    ";
+    for (int b : batches) cout << timeBatches(lp, queries, b) << "ms     ";
+    cout << "\n\n\n";
+}
+
+// building a table at load factor 0.9 from scratch: one insert per key
+// against bulk_load with all the threads
+template <typename Table>
+void bulkTable(const vector<string>& strings, const string& name) {
+    Table serial(N), bulk(N);
+    auto start = chrono::high_resolution_clock::now();
+    for (auto& s : strings) serial.insert(s, serial.getSize() + 1);
+    double serialMs = chrono::duration_cast<chrono::nanoseconds>(
+                          chrono::high_resolution_clock::now() - start)
+                          .count() /
+                      1000000.0;
+    start = chrono::high_resolution_clock::now();
+    bulk.bulk_load(strings);
+    double bulkMs = chrono::duration_cast<chrono::nanoseconds>(
+                        chrono::high_resolution_clock::now() - start)
+                        .count() /
+                    1000000.0;
+    int mismatches = 0;
+    for (auto& s : strings) mismatches += serial.getValue(s) != bulk.getValue(s);
+    cout << name << serialMs << "ms          " << bulkMs << "ms          " << mismatches << "\n";
+}
+
+void doBulkLoad() {
+    int needed = 0.9 * N;
+    cout << "Bulk load of " << needed << " keys with " << defaultThreads() << " threads:\n";
+    cout << "Method:            Insert Loop       Bulk Load         Mismatches\n";
+    vector<string> strings = generate_strings(needed, string_len);
+    bulkTable<SeparateChaining>(strings, "Separate Chaining: ");
+    bulkTable<Probing>(strings, "Linear Probing:    ");
+    cout << "\n\n";
+}
+
+void printProbingRow(const string& name, int id, int idx) {
+    cout << name;
+    cout << res[id][idx][0] << "ms          " << res[id][idx][1] << "       " << res[id][idx][2]
+         << "ms          " << res[id][idx][3] << "       " << res[id][idx][4] << "       "
+         << res[id][idx][5] << "\n";
+}
+
+// cold start: rebuilding a table by inserting every key again, against
+// mapping a snapshot of it and serving lookups from the file
+void doSnapshot() {
+    double lf = 0.9;
+    int needed = lf * N;
+    vector<string> strings = generate_strings(needed, string_len);
+    cout << "Snapshot at load factor " << lf << ":\n";
+
+    auto start = chrono::high_resolution_clock::now();
+    Probing lp(N);
+    lp.setProbingMethod(LinearProbing);
+    for (auto& s : strings) lp.insert(s, lp.getSize() + 1);
+    double rebuild = chrono::duration_cast<chrono::nanoseconds>(
+                         chrono::high_resolution_clock::now() - start)
+                         .count() /
+                     1000000.0;
+
+    start = chrono::high_resolution_clock::now();
+    saveSnapshot(lp, "probing.snap");
+    double save = chrono::duration_cast<chrono::nanoseconds>(
+                      chrono::high_resolution_clock::now() - start)
+                      .count() /
+                  1000000.0;
+
+    start = chrono::high_resolution_clock::now();
+    ProbingSnapshot snap;
+    bool loaded = snap.load("probing.snap");
+    double load = chrono::duration_cast<chrono::nanoseconds>(
+                      chrono::high_resolution_clock::now() - start)
+                      .count() /
+                  1000000.0;
+    if (!loaded) {
+        cout << "could not load probing.snap\n\n\n";
+        return;
+    }
+
+    // the first pass goes to the page cache / disk, the second one finds the
+    // pages mapped, so they are timed separately; only snapshot lookups are
+    // inside the timed loops, the check against lp comes after
+    int p = 0.1 * needed, wrong = 0;
+    vector<int> got(p);
+    double lookups[2];
+    for (int pass = 0; pass < 2; pass++) {
+        start = chrono::high_resolution_clock::now();
+        for (int i = 0; i < p; i++) got[i] = snap.getValue(strings[i]);
+        lookups[pass] = chrono::duration_cast<chrono::nanoseconds>(
                             chrono::high_resolution_clock::now() - start)
                             .count() /
-                        1000000.0;
-            probes += pp;
-        }
-        res[id2][idx][2] = tot_time / p;
-        res[id2][idx][3] = (double)probes / p;
-        cout << tot_time / p << "ms           " << (double)probes / p << "        ";
-        cout << "\n";
+                        1000000.0 / p;
     }
-    cout << "\n\n";
+    for (int i = 0; i < p; i++) {
+        if (got[i] != lp.getValue(strings[i])) wrong++;
+    }
+    cout << "Rebuild by insertion: " << rebuild << "ms\n";
+    cout << "Save:                 " << save << "ms\n";
+    cout << "Load (mmap):          " << load << "ms\n";
+    cout << "Lookup from snapshot: " << lookups[0] << "ms cold, " << lookups[1] << "ms warm (" << wrong
+         << " mismatches)\n\n\n";
 }
 
 void printLoadFactorBasedStats() {
@@ -208,27 +532,44 @@ void printLoadFactorBasedStats() {
         cout << "Method:            Time Before Deletion   Probes            "
                 "Time After Deletion  "
                 "  "
-                "Probes\n";
+                "Probes            Variance Before   Variance After\n";
         cout << "Separate Chaining: ";
         cout << res[0][idx][0] << "ms          N/A               " << res[0][idx][2]
              << "ms          N/A\n";
-        cout << "Linear Probing:    ";
-        cout << res[1][idx][0] << "ms          " << res[1][idx][1] << "       " << res[1][idx][2]
-             << "ms          " << res[1][idx][3] << "\n";
-        cout << "Quadratic Probing: ";
-        cout << res[2][idx][0] << "ms          " << res[2][idx][1] << "       " << res[2][idx][2]
-             << "ms          " << res[2][idx][3] << "\n";
-        cout << "Double Hashing:    ";
-        cout << res[3][idx][0] << "ms          " << res[3][idx][1] << "       " << res[3][idx][2]
-             << "ms          " << res[3][idx][3] << "\n";
+        cout << "Slab Chaining:     ";
+        cout << res[5][idx][0] << "ms          N/A               " << res[5][idx][2]
+             << "ms          N/A\n";
+        cout << "Chaining (short):  ";
+        cout << res[8][idx][0] << "ms          N/A               " << res[8][idx][2]
+             << "ms          N/A\n";
+        printProbingRow("Linear Probing:    ", 1, idx);
+        printProbingRow("Linear (short):    ", 9, idx);
+        printProbingRow("Quadratic Probing: ", 2, idx);
+        printProbingRow("Double Hashing:    ", 3, idx);
+        printProbingRow("Robin Hood:        ", 6, idx);
+        printProbingRow("Group Probing:     ", 4, idx);
+        printProbingRow("Cuckoo Hashing:    ", 7, idx);
         cout << "\n\n";
         cerr << lf << " done\n";
     }
 }
 
-int main() {
+void printHashStats(const string& name, HashFunction func) {
+    HashStats stats = test_hash(func, N);
+    cerr << name << " Performance: " << stats.rate << ", collision rate: " << stats.collisionRate
+         << ", throughput: " << stats.throughput << " GB/s (" << string_len << " bytes), "
+         << stats.longThroughput << " GB/s (1 KB)\n";
+}
+
+int main(int argc, char* argv[]) {
     // time(0) returns the current time
     srand(time(0));
+    // hash used by the tables: hash1 (default), wyhash or xxh3
+    if (argc > 1) {
+        string name = argv[1];
+        if (name == "wyhash") primaryHash = hash3;
+        else if (name == "xxh3") primaryHash = hash4;
+    }
     freopen("out.txt", "w", stdout);
 
     // testing both hash functions
@@ -236,8 +577,10 @@ int main() {
     cin >> N;
     cout << fixed << setprecision(9);
     cerr << fixed << setprecision(9);
-    cerr << "Hash Function 1 Performance: " << test_hash(&hash1, N) << "\n";
-    cerr << "Hash Function 2 Performance: " << test_hash(&hash2, N) << "\n";
+    printHashStats("Hash Function 1 (polynomial)", hash1);
+    printHashStats("Hash Function 2 (jenkins)", hash2);
+    printHashStats("Hash Function 3 (wyhash)", hash3);
+    printHashStats("Hash Function 4 (xxh3)", hash4);
 
     cerr << "Input N for hash table size: ";
     cin >> N;
@@ -245,12 +588,32 @@ int main() {
 
     doSeparateChaining();
     cerr << "Separate Chaining Done\n";
+    doSlabChaining();
+    cerr << "Slab Chaining Done\n";
     doProbing(LinearProbing);
     cerr << "Linear Probing Done\n";
     doProbing(QuadraticProbing);
     cerr << "Quadratic Probing Done\n";
     doProbing(DoubleHashing);
     cerr << "Double Hashing Done\n";
+    doRobinHood();
+    cerr << "Robin Hood Done\n";
+    doGroupProbing();
+    cerr << "Group Probing Done\n";
+    doCuckoo();
+    cerr << "Cuckoo Done\n";
+    doShortKeys();
+    cerr << "Short Keys Done\n";
+    doGrowth();
+    cerr << "Growth Done\n";
+    doBatch();
+    cerr << "Batch Done\n";
+    doBulkLoad();
+    cerr << "Bulk Load Done\n";
+    doSnapshot();
+    cerr << "Snapshot Done\n";
+    doConcurrent();
+    cerr << "Concurrent Done\n";
 
     printLoadFactorBasedStats();
 
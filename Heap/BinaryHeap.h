@@ -1,188 +1,181 @@
 #pragma once
-#include <unordered_map>
+#include <cstdlib>
+#include <new>
 #include <vector>
 
 #include "header.h"
 using namespace std;
 
-inline int LEFT(int x) { return x << 1; }
-inline int RIGHT(int x) { return ((x << 1) | 1); }
-inline int PARENT(int x) { return x >> 1; }
-
-// Min Heap
-template <typename T>
+// Min Heap, D-ary (D = 2, 4 or 8)
+// the root sits at index D - 1, so the D children of any node fill one
+// aligned block of D slots; with 16 byte Pairs and D = 4 that is exactly
+// one cache line, so every level of a sift-down touches a single line
+// sifting moves a hole instead of swapping, so every level costs one element
+// write and one position write instead of two of each
+template <typename T, int D = 2>
 class BinHeap {
+    static_assert(D == 2 || D == 4 || D == 8, "arity must be 2, 4 or 8");
+
    private:
+    static const int ROOT = D - 1;
+    static const int LINE = 64;
+
     T* arr;
-    // unordered_map<int, int> mp;
     int* mp;  // for keeping track of indices so that O(n) search is not needed
-    int maxSize, len;
-
-    void map_swap(int idx1, int idx2) {
-        // if you swap values at two indices,
-        // gotta swap their map values as well
-        assert(idx1 >= 1 && idx1 <= len);
-        assert(idx2 >= 1 && idx2 <= len);
-        int val1 = arr[idx1].u;
-        int val2 = arr[idx2].u;
-        mp[val1] = idx2;
-        mp[val2] = idx1;
+    int maxSize, mapSize, len;
+
+    static int PARENT(int x) { return x / D + D - 2; }
+    static int FIRST_CHILD(int x) { return D * x - D * D + 2 * D; }
+    int last() const { return ROOT + len - 1; }
+
+    static T* allocate(int sz) {
+        // ROOT + sz slots, rounded up to whole cache lines
+        size_t bytes = (ROOT + sz) * sizeof(T);
+        bytes = (bytes + LINE - 1) / LINE * LINE;
+        T* ret = (T*)aligned_alloc(LINE, bytes);
+        for (int i = 0; i < ROOT + sz; i++) new (&ret[i]) T();
+        return ret;
     }
 
-    void MIN_HEAPIFY(int idx) {
-        if (idx < 1) return;
-        int left = LEFT(idx);
-        int right = RIGHT(idx);
-        T minimum = arr[idx];
-        int min_idx = idx;
-        if (left <= len && arr[left] < minimum) {
-            minimum = arr[left];
-            min_idx = left;
-        }
-        if (right <= len && arr[right] < minimum) {
-            minimum = arr[right];
-            min_idx = right;
-        }
-        if (min_idx != idx) {
-            map_swap(idx, min_idx);
-            swap(arr[idx], arr[min_idx]);
-            MIN_HEAPIFY(min_idx);
+    void growMap(int u) {
+        int sz = mapSize;
+        while (sz <= u) sz *= 2;
+        int* another = new int[sz];
+        for (int i = 0; i < mapSize; i++) another[i] = mp[i];
+        delete[] mp;
+        mp = another;
+        mapSize = sz;
+    }
+
+    void place(int idx, const T& x) {
+        arr[idx] = x;
+        mp[x.u] = idx;
+    }
+
+    // x goes into the hole at idx or above it
+    void siftUp(int idx, T x) {
+        while (idx > ROOT) {
+            int parent = PARENT(idx);
+            if (!(x < arr[parent])) break;
+            place(idx, arr[parent]);
+            idx = parent;
         }
+        place(idx, x);
     }
 
-    int searchHelp(T val) {
-        int ret = -1;
-        for (int i = 1; i <= len; i++) {
-            if (arr[i] == val) {
-                ret = i;
-                break;
+    // x goes into the hole at idx or below it
+    void siftDown(int idx, T x) {
+        int end = last();
+        while (true) {
+            int first = FIRST_CHILD(idx);
+            if (first > end) break;
+            int stop = min(first + D, end + 1);
+            int min_idx = first;
+            for (int c = first + 1; c < stop; c++) {
+                if (arr[c] < arr[min_idx]) min_idx = c;
             }
+            if (!(arr[min_idx] < x)) break;
+            place(idx, arr[min_idx]);
+            idx = min_idx;
         }
-        return ret;
+        place(idx, x);
     }
 
-    void decreaseKeyHelp(int idx, T x) {
-        // debug("before decrease", x.u, x.w, arr[idx], arr[1]);
-        int parent;
-        while (idx > 1) {
-            parent = PARENT(idx);
-            if (x < arr[parent]) {
-                map_swap(idx, parent);
-                swap(arr[idx], arr[parent]);
-                idx = parent;
-            } else
-                break;
-        }
-        // debug("after decrease", x.u, x.w, arr[1]);
+    void copyFrom(const BinHeap& other) {
+        maxSize = other.maxSize;
+        mapSize = other.mapSize;
+        len = other.len;
+        arr = allocate(maxSize);
+        mp = new int[mapSize];
+        for (int i = 0; i < ROOT + maxSize; i++) arr[i] = other.arr[i];
+        for (int i = 0; i < mapSize; i++) mp[i] = other.mp[i];
     }
 
    public:
     BinHeap(int sz = 200) {
-        maxSize = sz;
+        maxSize = max(sz, 1);
+        mapSize = maxSize + 5;
         len = 0;
-        arr = new T[maxSize + 1];
-        mp = new int[maxSize + 5];
+        arr = allocate(maxSize);
+        mp = new int[mapSize];
     }
 
     BinHeap(const vector<T>& vec) {
-        maxSize = vec.size();
-        arr = new T[maxSize + 1];
-        mp = new int[maxSize + 5];
-        for (int i = 0; i < maxSize; i++) {
-            arr[i + 1] = vec[i];
-            mp[vec[i].u] = i + 1;
+        maxSize = max((int)vec.size(), 1);
+        mapSize = maxSize + 5;
+        arr = allocate(maxSize);
+        mp = new int[mapSize];
+        len = vec.size();
+        for (int i = 0; i < len; i++) {
+            if (vec[i].u >= mapSize) growMap(vec[i].u);
+            place(ROOT + i, vec[i]);
+        }
+        // bottom-up, from the parent of the last element
+        if (len > 1) {
+            for (int i = PARENT(last()); i >= ROOT; i--) siftDown(i, arr[i]);
         }
-        len = maxSize;
-        for (int i = (maxSize + 1) >> 1; i >= 1; i--) MIN_HEAPIFY(i);
     }
 
-    BinHeap(const BinHeap& other) {
-        maxSize = other.maxSize;
-        len = other.len;
-        delete[] arr;
-        arr = new T[maxSize + 1];
-        // mp.clear();
-        // mp = other.mp;
-        delete[] mp;
-        mp = new int[maxSize + 5];
-        for (int i = 0; i < maxSize + 1; i++) arr[i] = other.arr[i];
-        for (int i = 0; i < maxSize + 5; i++) mp[i] = other.mp[i];
-    }
+    BinHeap(const BinHeap& other) { copyFrom(other); }
 
     ~BinHeap() {
-        delete[] arr;
-        // mp.clear();
+        free(arr);
         delete[] mp;
         len = 0;
     }
 
     BinHeap& operator=(const BinHeap& other) {
         if (this == &other) return *this;
-        maxSize = other.maxSize;
-        len = other.len;
-        delete[] arr;
-        arr = new T[maxSize];
-        // mp.clear();
-        // mp = other.mp;
+        free(arr);
         delete[] mp;
-        mp = new int[maxSize + 5];
-        for (int i = 0; i < maxSize + 1; i++) arr[i] = other.arr[i];
-        for (int i = 0; i < maxSize + 5; i++) mp[i] = other.mp[i];
+        copyFrom(other);
+        return *this;
     }
 
     void insert(const T& x) {
         if (len == maxSize) {
-            maxSize *= 2;
-            T* another = new T[maxSize + 1];
-            int* anotherMp = new int[maxSize + 5];
-            for (int i = 0; i < maxSize + 1; i++) another[i] = arr[i];
-            for (int i = 0; i < maxSize + 5; i++) anotherMp[i] = mp[i];
-            delete[] arr;
-            delete[] mp;
+            T* another = allocate(maxSize * 2);
+            for (int i = 0; i < ROOT + maxSize; i++) another[i] = arr[i];
+            free(arr);
             arr = another;
-            mp = anotherMp;
-        }
-        arr[++len] = x;
-        mp[x.u] = len;
-        int idx = len;
-        int parent;
-        while (idx > 1) {
-            parent = PARENT(idx);
-            if (x < arr[parent]) {
-                map_swap(idx, parent);
-                swap(arr[idx], arr[parent]);
-                idx = parent;
-            } else
-                break;
+            maxSize *= 2;
         }
+        if (x.u >= mapSize) growMap(x.u);
+        len++;
+        siftUp(last(), x);
     }
 
     void decreaseKey(const T& x, long long newVal) {
-        // int idx2 = searchHelp(x);
-        // assert(idx != -1);
         int idx = mp[x.u];
-        assert(idx >= 1 && idx <= len);
+        assert(idx >= ROOT && idx <= last());
         assert(newVal <= arr[idx].w);
-        arr[idx].w = newVal;
-        decreaseKeyHelp(idx, arr[idx]);
+        T cur = arr[idx];
+        cur.w = newVal;
+        siftUp(idx, cur);
     }
 
     void deleteMin() {
         assert(len > 0);
-        // debug(arr[1]);
-        map_swap(1, len);
-        swap(arr[1], arr[len]);
-        // mp.erase(arr[len].u);
+        T x = arr[last()];
         len--;
-        MIN_HEAPIFY(1);
+        if (len > 0) siftDown(ROOT, x);
     }
 
+    T extractMin() {
+        T ret = getMin();
+        deleteMin();
+        return ret;
+    }
+
+    // positions of the dropped elements are left stale, they are never read
+    void clear() { len = 0; }
+
     T getMin() const {
         assert(len > 0);
-        return arr[1];
+        return arr[ROOT];
     }
 
     int getSize() const { return len; }
 
     bool isEmpty() const { return len == 0; }
-};
\ No newline at end of file
+};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <new>
+
 #include "header.h"
 
 template <typename T>
@@ -19,13 +21,29 @@ struct Node {
     }
 };
 
+const int MAX_DEGREE = 64;  // degrees stay below log_phi(n) < 45 for any int n
+
 // Min Heap
+// nodes come from one arena of size + 10 nodes (one per key, like mp),
+// allocated with the heap and recycled through a free list, so insert and
+// extractMin never call the allocator
 template <typename T>
 class FibHeap {
    private:
     Node<T>* min;
     Node<T>** mp;
     int n, maxSize;
+    Node<T>* pool;
+    Node<T>** freeList;
+    int poolSize, freeTop;
+    Node<T>* A[MAX_DEGREE];  // consolidate's degree table, reused by every call
+
+    Node<T>* newNode(const T& val) {
+        assert(freeTop > 0);
+        return new (freeList[--freeTop]) Node<T>(val);
+    }
+
+    void freeNode(Node<T>* x) { freeList[freeTop++] = x; }
 
     void printNode(Node<T>* cur) {
 #ifndef LOCAL
@@ -97,10 +115,22 @@ class FibHeap {
         y->marked = false;
     }
 
+    // frees the circular list at start and everything below it
+    void destroyList(Node<T>* start) {
+        Node<T>* cur = start;
+        do {
+            Node<T>* next = cur->right;
+            if (cur->child != nullptr) destroyList(cur->child);
+            mp[cur->val.u] = nullptr;
+            freeNode(cur);
+            cur = next;
+        } while (cur != start);
+    }
+
     void consolidate() {
         debug("Consolidation Start");
-        const int lg = __lg(n) + 2;
-        Node<T>** A = new Node<T>*[lg];
+        // max degree <= log_phi(n) < 1.4405 * (__lg(n) + 1)
+        const int lg = std::min(MAX_DEGREE, (int)(1.4405 * (__lg(n) + 1)) + 2);
         for (int i = 0; i < lg; i++) A[i] = nullptr;
         // iterate over all nodes w in the root list
 
@@ -159,7 +189,6 @@ class FibHeap {
         }
 
         // assert(min != nullptr);
-        delete[] A;
         debug("Consolidation End");
         // printRootList(min);
     }
@@ -171,25 +200,30 @@ class FibHeap {
         maxSize = size;
         mp = new Node<T>*[maxSize + 10];
         for (int i = 0; i < maxSize + 10; i++) mp[i] = nullptr;
+        poolSize = maxSize + 10;
+        pool = (Node<T>*)::operator new(sizeof(Node<T>) * poolSize);
+        freeList = new Node<T>*[poolSize];
+        // handed out from the front of the arena first
+        for (int i = 0; i < poolSize; i++) freeList[i] = pool + poolSize - 1 - i;
+        freeTop = poolSize;
     }
 
     ~FibHeap() {
-        while (min != nullptr) {
-            if (min == min->right) {
-                delete min;
-                min = nullptr;
-            } else
-                remove(min->right);
-        }
-        n = 0;
-        for (int i = 0; i < maxSize + 10; i++) {
-            if (mp[i] != nullptr) delete mp[i];
-        }
+        clear();
         delete[] mp;
+        delete[] freeList;
+        ::operator delete(pool);
+    }
+
+    // empties the heap in time proportional to what is left in it
+    void clear() {
+        if (min != nullptr) destroyList(min);
+        min = nullptr;
+        n = 0;
     }
 
     void insert(T val) {
-        Node<T>* x = new Node<T>(val);
+        Node<T>* x = newNode(val);
         x->left = x->right = x;
         // assert(val.u < maxSize + 10);
         mp[val.u] = x;
@@ -267,7 +301,7 @@ class FibHeap {
                   n);
         }
         T ret = z->val;
-        delete z;
+        freeNode(z);
         mp[ret.u] = nullptr;
         return ret;
     }
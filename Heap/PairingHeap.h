@@ -0,0 +1,103 @@
+#pragma once
+#include <vector>
+
+#include "header.h"
+using namespace std;
+
+// Min Heap, pairing heap
+// a heap-ordered tree kept as child / next-sibling links; insert and
+// decreaseKey just meld a tree into the root, extractMin pairs up the root's
+// children left to right and then melds the pairs right to left
+// nodes live in one array indexed by the key's u (like FibHeap's mp), so
+// links are ints and nothing is allocated after the constructor
+template <typename T>
+class PairingHeap {
+   private:
+    struct PNode {
+        T val;
+        int child, next;
+        int prev;  // previous sibling, or the parent for a first child
+    };
+
+    vector<PNode> nodes;
+    vector<int> pairs;  // scratch for extractMin
+    int root, n;
+
+    int meld(int a, int b) {
+        if (a == -1) return b;
+        if (b == -1) return a;
+        if (nodes[b].val < nodes[a].val) swap(a, b);
+        // b becomes the first child of a
+        nodes[b].prev = a;
+        nodes[b].next = nodes[a].child;
+        if (nodes[a].child != -1) nodes[nodes[a].child].prev = b;
+        nodes[a].child = b;
+        return a;
+    }
+
+    // detaches x (not the root) and its subtree from its parent
+    void cut(int x) {
+        int p = nodes[x].prev;
+        if (nodes[p].child == x) nodes[p].child = nodes[x].next;
+        else nodes[p].next = nodes[x].next;
+        if (nodes[x].next != -1) nodes[nodes[x].next].prev = p;
+        nodes[x].prev = nodes[x].next = -1;
+    }
+
+   public:
+    PairingHeap(int size) {
+        nodes.resize(size + 10);
+        root = -1;
+        n = 0;
+    }
+
+    void insert(T val) {
+        assert(val.u < (int)nodes.size());
+        nodes[val.u] = {val, -1, -1, -1};
+        root = meld(root, val.u);
+        n++;
+    }
+
+    T getMin() const {
+        assert(n > 0);
+        return nodes[root].val;
+    }
+
+    int getSize() const { return n; }
+
+    bool isEmpty() const { return n == 0; }
+
+    T extractMin() {
+        assert(n > 0);
+        T ret = nodes[root].val;
+        // first pass: meld the children two by two, left to right
+        pairs.clear();
+        int cur = nodes[root].child;
+        while (cur != -1) {
+            int a = cur, b = nodes[a].next;
+            cur = b == -1 ? -1 : nodes[b].next;
+            nodes[a].prev = nodes[a].next = -1;
+            if (b != -1) nodes[b].prev = nodes[b].next = -1;
+            pairs.push_back(meld(a, b));
+        }
+        // second pass: meld the pairs right to left
+        root = -1;
+        for (int i = (int)pairs.size() - 1; i >= 0; i--) root = meld(pairs[i], root);
+        n--;
+        return ret;
+    }
+
+    void decreaseKey(const T& p, long long newVal) {
+        int x = p.u;
+        assert(newVal <= nodes[x].val.w);
+        nodes[x].val.w = newVal;
+        if (x == root) return;
+        cut(x);
+        root = meld(root, x);
+    }
+
+    void clear() {
+        root = -1;
+        n = 0;
+    }
+};
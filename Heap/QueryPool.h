@@ -0,0 +1,69 @@
+#pragma once
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// work-stealing loop over the indices 0..count-1: f(worker, i) runs once for
+// every i, on one of `threads` threads (worker is that thread's number, so f
+// can keep per-thread scratch)
+// every worker starts with an equal slice and takes indices from its front;
+// one that runs dry steals the back half of another worker's slice, so a few
+// expensive indices can't leave the rest of the threads idle
+// a slice is a [lo, hi) range behind a lock, taken once per index: meant for
+// work items of microseconds or more, like whole queries
+class QueryPool {
+   private:
+    struct alignas(64) Slice {
+        mutex lock;
+        int lo, hi;
+    };
+
+    int threads;
+    vector<Slice> slices;
+
+    // the next index for worker w, or -1 when there is nothing left anywhere
+    int next(int w) {
+        {
+            lock_guard<mutex> guard(slices[w].lock);
+            if (slices[w].lo < slices[w].hi) return slices[w].lo++;
+        }
+        for (int i = 1; i < threads; i++) {
+            Slice& victim = slices[(w + i) % threads];
+            int lo, hi;
+            {
+                lock_guard<mutex> guard(victim.lock);
+                int left = victim.hi - victim.lo;
+                if (left <= 0) continue;
+                hi = victim.hi;
+                lo = victim.hi - (left + 1) / 2;
+                victim.hi = lo;
+            }
+            // the first stolen index is run now, the rest becomes w's slice
+            lock_guard<mutex> guard(slices[w].lock);
+            slices[w].lo = lo + 1;
+            slices[w].hi = hi;
+            return lo;
+        }
+        return -1;
+    }
+
+   public:
+    QueryPool(int threads) : threads(max(1, threads)), slices(this->threads) {}
+
+    template <typename F>
+    void run(int count, F f) {
+        for (int w = 0; w < threads; w++) {
+            slices[w].lo = (long long)count * w / threads;
+            slices[w].hi = (long long)count * (w + 1) / threads;
+        }
+        auto worker = [&](int w) {
+            for (int i = next(w); i != -1; i = next(w)) f(w, i);
+        };
+        vector<thread> workers;
+        for (int w = 1; w < threads; w++) workers.emplace_back(worker, w);
+        worker(0);
+        for (auto& t : workers) t.join();
+    }
+};
@@ -0,0 +1,110 @@
+#pragma once
+#include <vector>
+
+#include "header.h"
+using namespace std;
+
+// Min Heap, monotone radix heap for non-negative integer keys
+// keys can never go below the last extracted one (true for Dijkstra), so a
+// key is kept in bucket "highest bit in which it differs from last"; bucket 0
+// holds keys equal to last, and when it runs dry the next non-empty bucket is
+// split around its minimum, every key landing in a lower bucket
+// each key moves down at most 64 times in total, and nothing is compared
+// decreaseKey adds a new entry and leaves the old one behind as stale; an
+// entry is live only if it carries its key's latest stamp
+template <typename T>
+class RadixHeap {
+   private:
+    static const int BUCKETS = 65;
+
+    struct Entry {
+        T val;
+        unsigned stamp;
+    };
+
+    vector<Entry> buckets[BUCKETS];
+    vector<unsigned> stamp;  // per u, bumped by every insert and decreaseKey
+    vector<char> inHeap;     // per u
+    long long last;
+    int n;
+
+    int bucketOf(long long w) const {
+        return w == last ? 0 : 64 - __builtin_clzll((unsigned long long)(w ^ last));
+    }
+
+    bool live(const Entry& e) const { return inHeap[e.val.u] && stamp[e.val.u] == e.stamp; }
+
+    void push(const T& val) {
+        assert(val.w >= last);
+        buckets[bucketOf(val.w)].push_back({val, ++stamp[val.u]});
+    }
+
+    // brings a live entry to the back of bucket 0
+    void refill() {
+        while (!buckets[0].empty() && !live(buckets[0].back())) buckets[0].pop_back();
+        while (buckets[0].empty()) {
+            int i = 1;
+            while (buckets[i].empty()) i++;
+            long long newLast = -1;
+            for (const Entry& e : buckets[i]) {
+                if (live(e) && (newLast == -1 || e.val.w < newLast)) newLast = e.val.w;
+            }
+            if (newLast != -1) {
+                last = newLast;
+                for (const Entry& e : buckets[i]) {
+                    if (live(e)) buckets[bucketOf(e.val.w)].push_back(e);
+                }
+            }
+            buckets[i].clear();
+        }
+    }
+
+   public:
+    RadixHeap(int size) {
+        stamp.assign(size + 10, 0);
+        inHeap.assign(size + 10, 0);
+        last = 0;
+        n = 0;
+    }
+
+    void insert(T val) {
+        assert(val.u < (int)inHeap.size() && val.w >= 0);
+        inHeap[val.u] = 1;
+        push(val);
+        n++;
+    }
+
+    // not const: stale entries are dropped on the way
+    T getMin() {
+        assert(n > 0);
+        refill();
+        return buckets[0].back().val;
+    }
+
+    int getSize() const { return n; }
+
+    bool isEmpty() const { return n == 0; }
+
+    T extractMin() {
+        T ret = getMin();
+        buckets[0].pop_back();
+        inHeap[ret.u] = 0;
+        n--;
+        return ret;
+    }
+
+    void decreaseKey(const T& p, long long newVal) {
+        assert(inHeap[p.u]);
+        push({p.u, newVal});
+    }
+
+    // the keys may start again from 0
+    void clear() {
+        for (auto& b : buckets) {
+            for (const Entry& e : b) inHeap[e.val.u] = 0;
+            b.clear();
+        }
+        last = 0;
+        n = 0;
+    }
+};
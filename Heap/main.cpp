@@ -1,119 +1,254 @@
 #include <chrono>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <numeric>
 #include <vector>
 
+#include "../Graph/ContractionHierarchy.h"
+#include "../Graph/GraphLoader.h"
 #include "BinaryHeap.h"
 #include "FibHeap.h"
+#include "PairingHeap.h"
+#include "QueryPool.h"
+#include "RadixHeap.h"
 #include "header.h"
 using namespace std;
 
-struct Edge {
-    int u, v;
-    long long w;
-};
+// arity of the BinHeap, -DHEAP_ARITY=2 for a binary heap
+#ifndef HEAP_ARITY
+#define HEAP_ARITY 4
+#endif
 
 const long long INF = 2e16;
 int n_vertices, n_edges, k;
-vector<vector<Edge>> adj;
-vector<long long> dist_bn, dist_fb;
-vector<int> len_bn, len_fb;
+CSRGraph<long long> graph;
 vector<bool> visited;
+// lazy mode: vertices enter the heap when first reached, a query stops once
+// t is settled, and only the vertices the last query touched are reset
+bool lazy = false;
+// ch mode: queries run on the contraction hierarchy of graph.txt, built once
+// and kept in graph.txt.ch
+bool useCH = false;
+ContractionHierarchy<long long> hierarchy;
+
+enum HeapId { BINARY, FIBONACCI, PAIRING, RADIX, HEAPS };
+
+// everything a query writes, one per worker thread; every heap gets its own
+// distances, so their answers can be compared
+struct Scratch {
+    vector<long long> dist_q[HEAPS];
+    vector<int> len_q[HEAPS], touched_q[HEAPS];
+    vector<long long> dist_b[HEAPS];  // the ch query's search from t
+    vector<int> len_b[HEAPS];
+    // lazy and ch reuse a pair of heaps of each kind between queries
+    unique_ptr<BinHeap<Pair, HEAP_ARITY>> binary[2];
+    unique_ptr<FibHeap<Pair>> fibonacci[2];
+    unique_ptr<PairingHeap<Pair>> pairing[2];
+    unique_ptr<RadixHeap<Pair>> radix[2];
+
+    Scratch() {
+        // the lazy version expects everything unreached, then resets sparsely
+        for (int h = 0; h < HEAPS; h++) {
+            dist_q[h].assign(n_vertices + 2, INF);
+            len_q[h].assign(n_vertices + 2, 2e8);
+            if (useCH) {
+                dist_b[h].assign(n_vertices + 2, INF);
+                len_b[h].assign(n_vertices + 2, 2e8);
+            }
+        }
+    }
+};
+
+struct Answer {
+    int len;
+    long long dist;
+    double ms[HEAPS];
+};
 
-void dijkstra_bn(int s) {
+template <typename Heap>
+void dijkstra(int s, vector<long long>& dist, vector<int>& len) {
     // initialize-single-source-distance
-    fill(dist_bn.begin(), dist_bn.end(), INF);
-    fill(len_bn.begin(), len_bn.end(), 2e8);
-    dist_bn[s] = 0;
-    len_bn[s] = 0;
-    vector<Pair> v(n_vertices);
+    fill(dist.begin(), dist.end(), INF);
+    fill(len.begin(), len.end(), 2e8);
+    dist[s] = 0;
+    len[s] = 0;
+    Heap pq(n_vertices);
     // 0-based
     for (int i = 0; i < n_vertices; i++) {
         if (i == s)
-            v[i] = {i, 0};
+            pq.insert({i, 0});
         else
-            v[i] = {i, INF};
+            pq.insert({i, INF});
     }
-    BinHeap<Pair> pq(v);
     while (!pq.isEmpty()) {
         // extract-min
-        Pair cur = pq.getMin();
+        Pair cur = pq.extractMin();
         // debug(cur);
-        pq.deleteMin();
         int u = cur.u;
-        for (const Edge& e : adj[u]) {
-            int v = e.v;
+        for (int i = graph.offsets[u]; i < graph.offsets[u + 1]; i++) {
+            int v = graph.targets[i];
+            long long w = graph.weights[i];
             // relaxation
-            if (dist_bn[v] > dist_bn[u] + e.w) {
-                pq.decreaseKey({v, dist_bn[v]}, dist_bn[u] + e.w);
-                dist_bn[v] = dist_bn[u] + e.w;
-                len_bn[v] = len_bn[u] + 1;
+            if (dist[v] > dist[u] + w) {
+                pq.decreaseKey({v, dist[v]}, dist[u] + w);
+                dist[v] = dist[u] + w;
+                len[v] = len[u] + 1;
             }
         }
     }
-    // cerr << "Binary done\n";
 }
 
-void dijkstra_fb(int s) {
-    // initialize-single-source-distance
-    fill(dist_fb.begin(), dist_fb.end(), INF);
-    fill(len_fb.begin(), len_fb.end(), 2e8);
-    dist_fb[s] = 0;
-    len_fb[s] = 0;
-    FibHeap<Pair> fq(n_vertices);
-    // 0-based
-    for (int i = 0; i < n_vertices; i++) {
-        Pair p;
-        if (i == s)
-            p = {i, 0};
-        else
-            p = {i, INF};
-        fq.insert(p);
+void reset(vector<long long>& dist, vector<int>& len, vector<int>& touched) {
+    for (int v : touched) {
+        dist[v] = INF;
+        len[v] = 2e8;
     }
-    while (!fq.isEmpty()) {
-        // extract-min
-        Pair cur = fq.extractMin();
-        // debug(cur);
-        int u = cur.u;
-        for (const Edge& e : adj[u]) {
-            int v = e.v;
+    touched.clear();
+}
+
+template <typename Heap>
+void dijkstra_lazy(Heap& pq, int s, int t, vector<long long>& dist, vector<int>& len,
+                   vector<int>& touched) {
+    pq.clear();
+    reset(dist, len, touched);
+    dist[s] = 0;
+    len[s] = 0;
+    touched.push_back(s);
+    pq.insert({s, 0});
+    while (!pq.isEmpty()) {
+        int u = pq.extractMin().u;
+        if (u == t) break;  // settled, nothing later can improve it
+        for (int i = graph.offsets[u]; i < graph.offsets[u + 1]; i++) {
+            int v = graph.targets[i];
+            long long w = graph.weights[i];
             // relaxation
-            if (dist_fb[v] > dist_fb[u] + e.w) {
-                fq.decreaseKey({v, dist_fb[v]}, dist_fb[u] + e.w);
-                dist_fb[v] = dist_fb[u] + e.w;
-                len_fb[v] = len_fb[u] + 1;
+            if (dist[v] > dist[u] + w) {
+                if (dist[v] == INF) {  // first time reached
+                    pq.insert({v, dist[u] + w});
+                    touched.push_back(v);
+                } else {
+                    pq.decreaseKey({v, dist[v]}, dist[u] + w);
+                }
+                dist[v] = dist[u] + w;
+                len[v] = len[u] + 1;
             }
         }
     }
-    // cerr << "Fibonacci done\n";
 }
 
-int main() {
-    // undirected
-    ifstream in1;
-    in1.open("graph.txt");
-
-    in1 >> n_vertices >> n_edges;
-    adj.resize(n_vertices + 2);
-    dist_bn.resize(n_vertices + 2);
-    dist_fb.resize(n_vertices + 2);
-    len_bn.resize(n_vertices + 2);
-    len_fb.resize(n_vertices + 2);
-    visited.resize(n_vertices + 2);
+// upward searches from s (dist, len) and from t (distB, lenB) in the
+// hierarchy, each turn going to the smaller key; a side is done once its
+// smallest key can't beat the best meeting point, which ends up in dist[t]
+template <typename Heap>
+void dijkstra_ch(Heap& fq, Heap& bq, int s, int t, vector<long long>& dist, vector<int>& len,
+                 vector<long long>& distB, vector<int>& lenB, vector<int>& touched) {
+    fq.clear();
+    bq.clear();
+    for (int v : touched) {
+        distB[v] = INF;
+        lenB[v] = 2e8;
+    }
+    reset(dist, len, touched);
+    dist[s] = 0;
+    len[s] = 0;
+    distB[t] = 0;
+    lenB[t] = 0;
+    touched.push_back(s);
+    touched.push_back(t);
+    fq.insert({s, 0});
+    bq.insert({t, 0});
+    long long best = INF;
+    int bestLen = 2e8;
+    const CSRGraph<long long>& up = hierarchy.up;
 
-    for (int i = 1; i <= n_edges; i++) {
-        // assuming 0-based
-        // undirected graph as well
-        int u, v;
-        long long w;
-        in1 >> u >> v >> w;
-        Edge e = {u, v, w};
-        adj[u].push_back(e);
-        e = {v, u, w};
-        adj[v].push_back(e);
+    auto settle = [&](Heap& pq, vector<long long>& d, vector<int>& l, vector<long long>& other,
+                      vector<int>& otherLen) {
+        int u = pq.extractMin().u;
+        if (other[u] != INF && d[u] + other[u] < best) {
+            best = d[u] + other[u];
+            bestLen = l[u] + otherLen[u];
+        }
+        for (int i = up.offsets[u]; i < up.offsets[u + 1]; i++) {
+            int v = up.targets[i];
+            long long w = up.weights[i];
+            // relaxation
+            if (d[v] > d[u] + w) {
+                if (d[v] == INF) {  // first time reached from this side
+                    pq.insert({v, d[u] + w});
+                    if (other[v] == INF) touched.push_back(v);
+                } else {
+                    pq.decreaseKey({v, d[v]}, d[u] + w);
+                }
+                d[v] = d[u] + w;
+                l[v] = l[u] + hierarchy.hops[i];
+            }
+        }
+    };
+
+    while (true) {
+        bool forward = !fq.isEmpty() && fq.getMin().w < best;
+        bool backward = !bq.isEmpty() && bq.getMin().w < best;
+        if (!forward && !backward) break;
+        if (forward && (!backward || fq.getMin().w <= bq.getMin().w))
+            settle(fq, dist, len, distB, lenB);
+        else
+            settle(bq, distB, lenB, dist, len);
+    }
+    dist[t] = best;
+    len[t] = bestLen;
+}
+
+// one query with one kind of heap, returns the time in ms
+template <typename Heap>
+double runQuery(Scratch& sc, unique_ptr<Heap>* heaps, HeapId id, int s, int t) {
+    if ((lazy || useCH) && !heaps[0]) {
+        heaps[0] = make_unique<Heap>(n_vertices);
+        heaps[1] = make_unique<Heap>(n_vertices);
+    }
+    auto startTime = chrono::high_resolution_clock::now();
+    if (useCH)
+        dijkstra_ch(*heaps[0], *heaps[1], s, t, sc.dist_q[id], sc.len_q[id], sc.dist_b[id],
+                    sc.len_b[id], sc.touched_q[id]);
+    else if (lazy)
+        dijkstra_lazy(*heaps[0], s, t, sc.dist_q[id], sc.len_q[id], sc.touched_q[id]);
+    else
+        dijkstra<Heap>(s, sc.dist_q[id], sc.len_q[id]);
+    auto endTime = chrono::high_resolution_clock::now();
+    return chrono::duration_cast<chrono::nanoseconds>(endTime - startTime).count() /
+           (1000000.0);
+}
+
+// usage: main [eager | lazy | ch | contract] [threads]
+// contract only builds graph.txt.ch; ch builds it too if it is missing or
+// older than graph.txt
+// the queries are spread over the threads (by default one per core), each
+// with its own Scratch; the lines still come out in query order
+// output per query: len dist binary_ms fibonacci_ms pairing_ms radix_ms
+int main(int argc, char* argv[]) {
+    string mode = argc > 1 ? argv[1] : "";
+    lazy = mode == "lazy";
+    useCH = mode == "ch";
+    int threads = argc > 2 ? max(1, stoi(argv[2])) : max(1u, thread::hardware_concurrency());
+
+    // undirected, 0-based
+    EdgeList<long long> input;
+    if (!loadEdgeList("graph.txt", input)) {
+        cerr << "Could not read graph.txt\n";
+        return 1;
+    }
+    n_vertices = input.n;
+    n_edges = input.edges.size();
+    visited.resize(n_vertices + 2);
+    graph = buildCSR(n_vertices, input.edges, true);
+    if (mode == "contract" || useCH) {
+        auto startTime = chrono::high_resolution_clock::now();
+        hierarchy = hierarchyFor("graph.txt", graph, mode == "contract");
+        auto endTime = chrono::high_resolution_clock::now();
+        cerr << "hierarchy: " << hierarchy.up.edgeCount() << " upward edges, "
+             << chrono::duration_cast<chrono::milliseconds>(endTime - startTime).count() << "ms\n";
+        if (mode == "contract") return 0;
     }
-    in1.close();
 
     ifstream in2;
     in2.open("queries.txt");
@@ -121,30 +256,33 @@ int main() {
     out.open("output.txt");
 
     in2 >> k;
-    for (int q = 1; q <= k; q++) {
-        int s, t;
-        in2 >> s >> t;
-        auto startTime = chrono::high_resolution_clock::now();
-        dijkstra_bn(s);
-        auto endTime = chrono::high_resolution_clock::now();
-        double binary_time =
-            chrono::duration_cast<chrono::nanoseconds>(endTime - startTime)
-                .count() /
-            (1000000.0);
-        // cout << "Binary: " << dist_bn[t] << " " << len_bn[t] << endl;
-
-        startTime = chrono::high_resolution_clock::now();
-        dijkstra_fb(s);
-        endTime = chrono::high_resolution_clock::now();
-        double fibonacci_time =
-            chrono::duration_cast<chrono::nanoseconds>(endTime - startTime)
-                .count() /
-            (1000000.0);
-        // debug(len_fb[t], len_bn[t], dist_fb[t], dist_bn[t]);
-        // cout << "Fibonacci: " << dist_fb[t] << " " << len_fb[t] << endl;
-
-        out << len_bn[t] << " " << dist_bn[t] << " " << binary_time << "ms "
-            << fibonacci_time << "ms\n";
+    vector<int> from(k), to(k);
+    for (int q = 0; q < k; q++) in2 >> from[q] >> to[q];
+
+    vector<Answer> answers(k);
+    vector<unique_ptr<Scratch>> scratch(min(threads, max(k, 1)));
+    QueryPool pool(scratch.size());
+    pool.run(k, [&](int w, int q) {
+        if (!scratch[w]) scratch[w] = make_unique<Scratch>();
+        Scratch& sc = *scratch[w];
+        int s = from[q], t = to[q];
+        Answer& a = answers[q];
+        a.ms[BINARY] = runQuery(sc, sc.binary, BINARY, s, t);
+        a.ms[FIBONACCI] = runQuery(sc, sc.fibonacci, FIBONACCI, s, t);
+        a.ms[PAIRING] = runQuery(sc, sc.pairing, PAIRING, s, t);
+        a.ms[RADIX] = runQuery(sc, sc.radix, RADIX, s, t);
+        for (int h = 1; h < HEAPS; h++) {
+            if (sc.dist_q[h][t] != sc.dist_q[BINARY][t]) {
+                debug("heaps disagree", h, s, t);
+            }
+        }
+        a.len = sc.len_q[BINARY][t];
+        a.dist = sc.dist_q[BINARY][t];
+    });
+
+    for (const Answer& a : answers) {
+        out << a.len << " " << a.dist << " " << a.ms[BINARY] << "ms " << a.ms[FIBONACCI] << "ms "
+            << a.ms[PAIRING] << "ms " << a.ms[RADIX] << "ms\n";
     }
 
     in2.close();
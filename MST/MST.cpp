@@ -1,43 +1,36 @@
 #include <cassert>
-#include <fstream>
 #include <iostream>
 #include <vector>
 
+#include "../Graph/GraphLoader.h"
 #include "Kruskal.hpp"
 #include "Prim.hpp"
 using namespace std;
 
 const double EPS = 1e-9;
 // Edge struct contains from, Edge2 does not
-vector<vector<Edge2>> adj;  // for Prim
-vector<Edge> edges;         // for Kruskal
+CSRGraph<double> graph;  // for Prim
+vector<Edge> edges;      // for Kruskal
 vector<pair<int, int>> prim_ans, kruskal_ans;
 
 int main() {
-    ifstream in;
-    in.open("mst.txt");
+    EdgeList<double> input;
+    if (!loadEdgeList("mst.txt", input)) {
+        cerr << "Could not read mst.txt\n";
+        return 1;
+    }
 
-    int n, m;
-    in >> n >> m;
-    adj.resize(n + 1);
+    int n = input.n, m = input.edges.size();
     edges.resize(m);
-
     for (int i = 0; i < m; i++) {
-        int a, b;
-        double c;
-        in >> a >> b >> c;
-        Edge2 e;
-        e.to = b;
-        e.weight = c;
-        adj[a].push_back(e);
-        e.to = a;
-        adj[b].push_back(e);
-        edges[i].from = a;
-        edges[i].to = b;
-        edges[i].weight = c;
+        edges[i].from = input.edges[i].from;
+        edges[i].to = input.edges[i].to;
+        edges[i].weight = input.edges[i].weight;
     }
 
-    double prim_weight = prim(adj, prim_ans, n);
+    graph = buildCSR(n, input.edges, true);
+
+    double prim_weight = prim(graph, prim_ans, n);
     double kruskal_weight = kruskal(edges, kruskal_ans, n);
 
     // assert(abs(prim_weight - kruskal_weight) < EPS && prim_ans.size() == n -
@@ -64,5 +57,4 @@ int main() {
             cout << "}" << endl;
     }
 
-    in.close();
 }
\ No newline at end of file
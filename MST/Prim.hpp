@@ -2,6 +2,8 @@
 #include <algorithm>
 #include <queue>
 #include <vector>
+
+#include "../Graph/CSRGraph.h"
 using namespace std;
 
 const double INF = 2e9;
@@ -17,7 +19,7 @@ struct Edge2 {
 
 // prim_ans is the vector to store the resulting MST
 // taken records if a node has been included in the MST
-double primHelp(vector<vector<Edge2>>& adj, vector<bool>& taken,
+double primHelp(const CSRGraph<double>& graph, vector<bool>& taken,
                 vector<double>& key, vector<pair<int, int>>& prim_ans,
                 int source) {
     priority_queue<pair<Edge2, int>, vector<pair<Edge2, int>>,
@@ -46,9 +48,10 @@ double primHelp(vector<vector<Edge2>>& adj, vector<bool>& taken,
             prim_ans.push_back(make_pair(ret.second, ret.first.to));
         }
 
-        for (int i = 0; i < adj[u].size(); i++) {  // will run O(E) in total
-            int v = adj[u][i].to;
-            double weight = adj[u][i].weight;
+        // will run O(E) in total
+        for (int i = graph.offsets[u]; i < graph.offsets[u + 1]; i++) {
+            int v = graph.targets[i];
+            double weight = graph.weights[i];
             if (!taken[v] && key[v] > weight) {
                 key[v] = weight;  // decrease-key operation
                 Edge2 temp;
@@ -68,14 +71,14 @@ double primHelp(vector<vector<Edge2>>& adj, vector<bool>& taken,
 // for a disconnected graph, there will be multiple MSTs resulting in
 // Minimum Spanning Forest. We want to go through every node, and if a node
 // is not already part of an MST, run Prim's from it
-double prim(vector<vector<Edge2>>& adj, vector<pair<int, int>>& prim_ans,
+double prim(const CSRGraph<double>& graph, vector<pair<int, int>>& prim_ans,
             int n) {
     // 0-based
     vector<bool> taken(n + 1, false);  // if a vertex is included in the MST
     vector<double> key(n + 1, INF);
     double ans = 0;
     for (int i = 0; i < n; i++) {
-        if (!taken[i]) ans += primHelp(adj, taken, key, prim_ans, i);
+        if (!taken[i]) ans += primHelp(graph, taken, key, prim_ans, i);
     }
     return ans;
 }
\ No newline at end of file
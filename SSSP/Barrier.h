@@ -0,0 +1,27 @@
+#pragma once
+#include <condition_variable>
+#include <mutex>
+using namespace std;
+
+// all the threads wait here until the last one arrives
+class Barrier {
+   private:
+    mutex lock;
+    condition_variable cv;
+    int count, waiting = 0, generation = 0;
+
+   public:
+    Barrier(int count) : count(count) {}
+
+    void wait() {
+        unique_lock<mutex> guard(lock);
+        int gen = generation;
+        if (++waiting == count) {
+            waiting = 0;
+            generation++;
+            cv.notify_all();
+        } else {
+            cv.wait(guard, [&]() { return gen != generation; });
+        }
+    }
+};
@@ -1,8 +1,10 @@
-#include <fstream>
 #include <iostream>
 #include <queue>
 #include <stack>
+#include <string>
 #include <vector>
+
+#include "../Graph/GraphLoader.h"
 using namespace std;
 
 typedef long long ll;
@@ -17,7 +19,7 @@ struct Edge {
 
 const ll INF = 2e15;
 int n, m, s, d;
-vector<vector<Edge>> adj;
+CSRGraph<ll> graph;
 vector<ll> dist;
 vector<int> parent;
 
@@ -27,9 +29,9 @@ bool bellman_ford(int source) {
     for (int i = 1; i <= n; i++) {
         bool changed = false;
         for (int from = 0; from < n; from++) {
-            for (auto& edge : adj[from]) {
-                int to = edge.to;
-                ll weight = edge.weight;
+            for (int e = graph.offsets[from]; e < graph.offsets[from + 1]; e++) {
+                int to = graph.targets[e];
+                ll weight = graph.weights[e];
                 if (dist[from] < INF) {
                     if (dist[to] > dist[from] + weight) {
                         if (i == n) return false;
@@ -45,20 +47,73 @@ bool bellman_ford(int source) {
     return true;
 }
 
-int main() {
-    ifstream in;
-    in.open("bellman_in.txt");
-    in >> n >> m;
-    adj.resize(n + 1);
+// whether the parent pointers of the reached vertices go round in a circle;
+// they only can if the edges on it add up to less than zero
+bool parent_cycle() {
+    vector<int> walk(n, -1);  // which walk first went through the vertex
+    for (int start = 0; start < n; start++) {
+        if (walk[start] != -1 || dist[start] == INF) continue;
+        int v = start;
+        while (v != -1 && walk[v] == -1) {
+            walk[v] = start;
+            v = parent[v];
+        }
+        if (v != -1 && walk[v] == start) return true;
+    }
+    return false;
+}
+
+// worklist version (SPFA): only the out-edges of vertices whose distance
+// changed are relaxed again, so a graph that settles in a few rounds costs
+// about that many rounds' worth of the changed vertices' edges
+// a negative cycle would keep it going forever: every n relaxations the parent
+// pointers are checked for a cycle, and a vertex queued n times also gives up
+bool spfa(int source) {
+    dist[source] = 0;
+    parent[source] = -1;
+    queue<int> q;
+    vector<bool> queued(n, false);
+    vector<int> times(n, 0);
+    q.push(source);
+    queued[source] = true;
+    long long relaxations = 0;
+    while (!q.empty()) {
+        int from = q.front();
+        q.pop();
+        queued[from] = false;
+        for (int e = graph.offsets[from]; e < graph.offsets[from + 1]; e++) {
+            int to = graph.targets[e];
+            ll weight = graph.weights[e];
+            if (dist[to] > dist[from] + weight) {
+                dist[to] = dist[from] + weight;
+                parent[to] = from;
+                if (++relaxations % n == 0 && parent_cycle()) return false;
+                if (!queued[to]) {
+                    if (++times[to] >= n) return false;
+                    queued[to] = true;
+                    q.push(to);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// usage: Bellman-Ford [spfa]
+int main(int argc, char* argv[]) {
+    EdgeList<ll> input;
+    if (!loadEdgeList("bellman_in.txt", input) || input.tail.size() < 2) {
+        cerr << "Could not read bellman_in.txt\n";
+        return 1;
+    }
+    n = input.n;
+    m = input.edges.size();
     dist.assign(n + 1, INF);
     parent.resize(n + 1);
-    for (int i = 0; i < m; i++) {
-        int a, b, c;
-        in >> a >> b >> c;
-        adj[a].push_back({b, c});
-    }
-    in >> s >> d;
-    bool ret = bellman_ford(s);
+    graph = buildCSR(n, input.edges);
+    s = input.tail[0];
+    d = input.tail[1];
+    bool ret = argc > 1 && string(argv[1]) == "spfa" ? spfa(s) : bellman_ford(s);
     if (!ret) {
         cout << "The graph contains a negative cycle\n";
         return 0;
@@ -80,5 +135,4 @@ int main() {
         }
         cout << "\n";
     }
-    in.close();
 }
\ No newline at end of file
@@ -0,0 +1,184 @@
+#include <iostream>
+#include <stack>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Graph/GraphLoader.h"
+#include "Barrier.h"
+using namespace std;
+
+// delta-stepping SSSP (Meyer and Sanders), same input and output as
+// Dijkstra.cpp
+// vertices sit in buckets of width delta by tentative distance; the lowest
+// bucket is emptied by relaxing light edges (w <= delta) over and over, since
+// those can land in the same bucket, and then the heavy edges of everything
+// it settled are relaxed once
+// every relaxation step is split over the threads twice: each thread scans
+// its share of the frontier and sorts the requests by owner (v % threads),
+// then each thread applies the requests for the vertices it owns, so no two
+// threads ever write the same dist or parent
+// the result is the same for the same thread count; the cost always matches
+// Dijkstra's, but with equal-cost paths the one printed may differ
+//
+// usage: DeltaStepping [delta] [threads]
+
+typedef long long ll;
+
+struct Request {
+    int v, from;
+    ll dist;
+};
+
+const ll INF = 2e15;
+int n, m, s, d;
+CSRGraph<ll> graph;
+vector<ll> dist;
+vector<int> parent;
+
+void delta_stepping(int source, ll delta, int threads) {
+    ll maxWeight = 0;
+    for (ll w : graph.weights) maxWeight = max(maxWeight, w);
+    // an edge never reaches nb or more buckets ahead, so they can be reused
+    // cyclically
+    int nb = maxWeight / delta + 2;
+    vector<vector<int>> buckets(nb);
+    vector<ll> stamp(n, -1), settledStamp(n, -1);  // frontier / settled dedup
+    vector<int> frontier, settled;
+    vector<vector<vector<Request>>> requests(threads, vector<vector<Request>>(threads));
+    vector<vector<int>> changed(threads);
+    vector<char> isChanged(n, 0);
+    ll cur = 0, step = 0;
+    bool heavy = false, done = false;
+
+    parent[source] = -1;
+    dist[source] = 0;
+    buckets[0].push_back(source);
+
+    // serial part between the parallel steps: files the changed vertices into
+    // their buckets and picks the next frontier, or sets done
+    auto prepare = [&]() {
+        for (int t = 0; t < threads; t++) {
+            for (int v : changed[t]) {
+                isChanged[v] = 0;
+                buckets[dist[v] / delta % nb].push_back(v);
+            }
+            changed[t].clear();
+        }
+        frontier.clear();
+        while (true) {
+            if (!heavy) {
+                // light step: whatever is (still) in the current bucket
+                step++;
+                vector<int>& b = buckets[cur % nb];
+                for (int v : b) {
+                    if (dist[v] / delta != cur || stamp[v] == step) continue;  // stale or twice
+                    stamp[v] = step;
+                    frontier.push_back(v);
+                    if (settledStamp[v] != cur) {
+                        settledStamp[v] = cur;
+                        settled.push_back(v);
+                    }
+                }
+                b.clear();
+                if (!frontier.empty()) return;
+                // the bucket stays empty now: heavy edges of what it settled
+                heavy = true;
+                frontier.swap(settled);
+                if (!frontier.empty()) return;
+            }
+            heavy = false;
+            ll next = cur + 1;
+            while (next < cur + nb && buckets[next % nb].empty()) next++;
+            if (next == cur + nb) {
+                done = true;
+                return;
+            }
+            cur = next;
+        }
+    };
+
+    Barrier barrier(threads);
+    auto worker = [&](int t) {
+        while (true) {
+            if (t == 0) prepare();
+            barrier.wait();
+            if (done) break;
+            // relaxation requests for this thread's share of the frontier
+            int lo = (ll)frontier.size() * t / threads, hi = (ll)frontier.size() * (t + 1) / threads;
+            for (int k = lo; k < hi; k++) {
+                int u = frontier[k];
+                for (int i = graph.offsets[u]; i < graph.offsets[u + 1]; i++) {
+                    ll w = graph.weights[i];
+                    if ((w > delta) != heavy) continue;
+                    int v = graph.targets[i];
+                    if (dist[u] + w < dist[v]) requests[t][v % threads].push_back({v, u, dist[u] + w});
+                }
+            }
+            barrier.wait();
+            // the requests for the vertices this thread owns, in thread order
+            for (int g = 0; g < threads; g++) {
+                for (const Request& r : requests[g][t]) {
+                    if (r.dist < dist[r.v]) {
+                        dist[r.v] = r.dist;
+                        parent[r.v] = r.from;
+                        if (!isChanged[r.v]) {
+                            isChanged[r.v] = 1;
+                            changed[t].push_back(r.v);
+                        }
+                    }
+                }
+                requests[g][t].clear();
+            }
+            barrier.wait();
+        }
+    };
+
+    vector<thread> workers;
+    for (int t = 1; t < threads; t++) workers.emplace_back(worker, t);
+    worker(0);
+    for (auto& w : workers) w.join();
+}
+
+int main(int argc, char* argv[]) {
+    EdgeList<ll> input;
+    if (!loadEdgeList("d_in.txt", input) || input.tail.size() < 2) {
+        cerr << "Could not read d_in.txt\n";
+        return 1;
+    }
+    n = input.n;
+    m = input.edges.size();
+    dist.assign(n + 1, INF);
+    parent.resize(n + 1);
+    graph = buildCSR(n, input.edges);
+    s = input.tail[0];
+    d = input.tail[1];
+
+    // by default about the largest weight over the average degree, so a
+    // light step touches around one bucket's worth of edges
+    ll maxWeight = 1;
+    for (ll w : graph.weights) maxWeight = max(maxWeight, w);
+    ll delta = max(1LL, maxWeight / max(1, m / max(1, n)));
+    int threads = max(1u, thread::hardware_concurrency());
+    if (argc > 1) delta = max(1LL, stoll(argv[1]));
+    if (argc > 2) threads = max(1, stoi(argv[2]));
+    delta = max(delta, maxWeight >> 20);  // at most about a million buckets
+
+    delta_stepping(s, delta, threads);
+    if (d >= n || dist[d] == INF) {
+        cout << "Destination unreachable from source\n";
+    } else {
+        cout << "Shortest path cost: " << dist[d] << "\n";
+        stack<int> st;
+        while (d != -1) {
+            st.push(d);
+            d = parent[d];
+        }
+        while (!st.empty()) {
+            cout << st.top() << " ";
+            st.pop();
+            if (!st.empty()) cout << "-> ";
+        }
+        cout << "\n";
+    }
+}
@@ -1,8 +1,9 @@
-#include <fstream>
 #include <iostream>
 #include <queue>
 #include <stack>
 #include <vector>
+
+#include "../Graph/GraphLoader.h"
 using namespace std;
 
 typedef long long ll;
@@ -17,7 +18,7 @@ struct Edge {
 
 const ll INF = 2e15;
 int n, m, s, d;
-vector<vector<Edge>> adj;
+CSRGraph<ll> graph;
 vector<ll> dist;
 vector<int> parent;
 vector<bool> visited;
@@ -32,30 +33,31 @@ void dijkstra(int source) {
         pq.pop();
         if (visited[from]) continue;
         visited[from] = true;
-        for (auto& edge : adj[from]) {
-            if (dist[edge.to] > dist[from] + edge.weight) {
-                dist[edge.to] = dist[from] + edge.weight;
-                parent[edge.to] = from;
-                pq.push({edge.to, dist[edge.to]});
+        for (int i = graph.offsets[from]; i < graph.offsets[from + 1]; i++) {
+            int to = graph.targets[i];
+            if (dist[to] > dist[from] + graph.weights[i]) {
+                dist[to] = dist[from] + graph.weights[i];
+                parent[to] = from;
+                pq.push({to, dist[to]});
             }
         }
     }
 }
 
 int main() {
-    ifstream in;
-    in.open("d_in.txt");
-    in >> n >> m;
-    adj.resize(n + 1);
+    EdgeList<ll> input;
+    if (!loadEdgeList("d_in.txt", input) || input.tail.size() < 2) {
+        cerr << "Could not read d_in.txt\n";
+        return 1;
+    }
+    n = input.n;
+    m = input.edges.size();
     dist.assign(n + 1, INF);
     parent.resize(n + 1);
     visited.assign(n + 1, false);
-    for (int i = 0; i < m; i++) {
-        int a, b, c;
-        in >> a >> b >> c;
-        adj[a].push_back({b, c});
-    }
-    in >> s >> d;
+    graph = buildCSR(n, input.edges);
+    s = input.tail[0];
+    d = input.tail[1];
     dijkstra(s);
     if (d >= n || dist[d] == INF) {
         cout << "Destination unreachable from source\n";
@@ -73,5 +75,4 @@ int main() {
         }
         cout << "\n";
     }
-    in.close();
 }
\ No newline at end of file
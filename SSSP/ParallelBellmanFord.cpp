@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <queue>
+#include <stack>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Graph/GraphLoader.h"
+#include "Barrier.h"
+using namespace std;
+
+// multithreaded Bellman-Ford, same input and output as Bellman-Ford.cpp
+// the vertices are split into one range per thread holding about the same
+// number of out-edges, and every round each thread relaxes the edges of its
+// range; dist is lowered with a compare-and-swap min, and a round that lowered
+// nothing anywhere ends the loop
+// a thread may already see values lowered earlier in the same round, which
+// only speeds things up: without a negative cycle every dist is final after
+// n - 1 rounds whatever the interleaving, and with one round n still lowers
+// something, so the verdict never depends on the timing
+// a negative cycle is usually caught long before round n: no simple path is
+// shorter than the n - 1 most negative weights put together, so a dist below
+// that can only come from going round a negative cycle
+// parents are not raced for: once dist is final, a breadth-first walk from
+// the source over the tight edges (dist[u] + w == dist[v]), in CSR order,
+// gives every vertex its parent, the same one on every run
+//
+// usage: ParallelBellmanFord [threads]
+
+typedef long long ll;
+
+const ll INF = 2e15;
+int n, m, s, d;
+CSRGraph<ll> graph;
+vector<ll> dist;
+vector<int> parent;
+
+bool bellman_ford(int source, int threads) {
+    vector<atomic<ll>> best(n);
+    for (int v = 0; v < n; v++) best[v].store(INF, memory_order_relaxed);
+    best[source].store(0, memory_order_relaxed);
+
+    // range t is vertices [bound[t], bound[t + 1])
+    vector<int> bound(threads + 1, n);
+    for (int t = 0; t < threads; t++) {
+        ll edges = (ll)graph.edgeCount() * t / threads;
+        bound[t] = lower_bound(graph.offsets.begin(), graph.offsets.begin() + n, edges) -
+                   graph.offsets.begin();
+    }
+
+    // the lightest any simple path can be
+    vector<ll> negative;
+    for (ll w : graph.weights) {
+        if (w < 0) negative.push_back(w);
+    }
+    if (n > 0 && (int)negative.size() > n - 1) {
+        nth_element(negative.begin(), negative.begin() + (n - 1), negative.end());
+        negative.resize(n - 1);
+    }
+    ll floor = 0;
+    for (ll w : negative) floor += w;
+
+    atomic<bool> changed(false), tooLow(false);
+    bool done = false, cycle = false;
+    int round = 1;
+    Barrier barrier(threads);
+    auto worker = [&](int t) {
+        while (true) {
+            bool lowered = false;
+            for (int from = bound[t]; from < bound[t + 1]; from++) {
+                ll df = best[from].load(memory_order_relaxed);
+                if (df >= INF) continue;
+                for (int e = graph.offsets[from]; e < graph.offsets[from + 1]; e++) {
+                    atomic<ll>& slot = best[graph.targets[e]];
+                    ll nd = df + graph.weights[e];
+                    ll cur = slot.load(memory_order_relaxed);
+                    while (nd < cur) {
+                        if (slot.compare_exchange_weak(cur, nd, memory_order_relaxed)) {
+                            lowered = true;
+                            if (nd < floor) tooLow.store(true, memory_order_relaxed);
+                            break;
+                        }
+                    }
+                }
+            }
+            if (lowered) changed.store(true, memory_order_relaxed);
+            barrier.wait();
+            if (t == 0) {
+                if (!changed.load(memory_order_relaxed)) done = true;
+                else if (round == n || tooLow.load(memory_order_relaxed)) done = cycle = true;
+                changed.store(false, memory_order_relaxed);
+                round++;
+            }
+            barrier.wait();
+            if (done) break;
+        }
+    };
+    vector<thread> workers;
+    for (int t = 1; t < threads; t++) workers.emplace_back(worker, t);
+    worker(0);
+    for (auto& w : workers) w.join();
+    if (cycle) return false;
+
+    for (int v = 0; v < n; v++) dist[v] = best[v].load(memory_order_relaxed);
+    vector<bool> seen(n, false);
+    queue<int> q;
+    parent[source] = -1;
+    seen[source] = true;
+    q.push(source);
+    while (!q.empty()) {
+        int from = q.front();
+        q.pop();
+        for (int e = graph.offsets[from]; e < graph.offsets[from + 1]; e++) {
+            int to = graph.targets[e];
+            if (!seen[to] && dist[from] + graph.weights[e] == dist[to]) {
+                seen[to] = true;
+                parent[to] = from;
+                q.push(to);
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    EdgeList<ll> input;
+    if (!loadEdgeList("bellman_in.txt", input) || input.tail.size() < 2) {
+        cerr << "Could not read bellman_in.txt\n";
+        return 1;
+    }
+    n = input.n;
+    m = input.edges.size();
+    dist.assign(n + 1, INF);
+    parent.resize(n + 1);
+    graph = buildCSR(n, input.edges);
+    s = input.tail[0];
+    d = input.tail[1];
+    int threads = max(1u, thread::hardware_concurrency());
+    if (argc > 1) threads = max(1, stoi(argv[1]));
+
+    bool ret = bellman_ford(s, threads);
+    if (!ret) {
+        cout << "The graph contains a negative cycle\n";
+        return 0;
+    }
+    if (d >= n || dist[d] == INF) {
+        cout << "Destination unreachable from source\n";
+    } else {
+        cout << "The graph does not contain a negative cycle\n";
+        cout << "Shortest path cost: " << dist[d] << "\n";
+        stack<int> st;
+        while (d != -1) {
+            st.push(d);
+            d = parent[d];
+        }
+        while (!st.empty()) {
+            cout << st.top() << " ";
+            st.pop();
+            if (!st.empty()) cout << "-> ";
+        }
+        cout << "\n";
+    }
+}
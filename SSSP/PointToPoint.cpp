@@ -0,0 +1,323 @@
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <queue>
+#include <stack>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../Graph/GraphLoader.h"
+using namespace std;
+
+// point-to-point shortest paths on the graph of d_in.txt
+// - bidirectional: Dijkstra from s on the graph and from t on the reversed
+//   graph, alternating, until the two smallest keys add up to at least the
+//   best s-t path seen so far
+// - alt: A* from s, guided by landmark (ALT) lower bounds: for a landmark L,
+//   d(v, t) >= d(L, t) - d(L, v) and d(v, t) >= d(v, L) - d(t, L)
+// the landmark distances are computed once and kept next to the graph in
+// d_in.txt.alt, which is rebuilt whenever it is older than d_in.txt
+// every pair of numbers after the edges is a query; each one prints the same
+// lines Dijkstra.cpp does, and only the vertices a query touched are reset
+//
+// usage: PointToPoint [bidirectional|alt] [landmarks]
+
+typedef long long ll;
+struct Edge {
+    int to;
+    ll weight;
+    bool operator>(const Edge& other) const {
+        if (weight != other.weight) return weight > other.weight;
+        return to > other.to;
+    }
+};
+
+const ll INF = 2e15;
+const char ALT_MAGIC[8] = {'A', 'L', 'T', 'L', 'M', '0', '1', '\0'};
+int n, m, k, asked;  // landmarks in use / asked for
+CSRGraph<ll> graph, reverse_graph;
+vector<ll> dist, dist_back, h;
+vector<int> parent, parent_back;
+vector<bool> visited, visited_back;
+vector<int> touched;
+vector<int> landmarks;
+vector<vector<ll>> from_landmark, to_landmark;  // d(L, v) and d(v, L)
+
+// plain Dijkstra over every vertex, for the landmark tables
+vector<ll> full_dijkstra(const CSRGraph<ll>& g, int source) {
+    vector<ll> d(n, INF);
+    d[source] = 0;
+    priority_queue<Edge, vector<Edge>, greater<Edge>> pq;
+    pq.push({source, 0});
+    while (!pq.empty()) {
+        Edge top = pq.top();
+        pq.pop();
+        int from = top.to;
+        if (top.weight > d[from]) continue;
+        for (int i = g.offsets[from]; i < g.offsets[from + 1]; i++) {
+            int to = g.targets[i];
+            if (d[to] > d[from] + g.weights[i]) {
+                d[to] = d[from] + g.weights[i];
+                pq.push({to, d[to]});
+            }
+        }
+    }
+    return d;
+}
+
+// farthest-first: every new landmark is the vertex farthest from the ones
+// picked so far (unreached vertices don't count)
+void pick_landmarks() {
+    landmarks.clear();
+    from_landmark.clear();
+    to_landmark.clear();
+    vector<ll> closest(n, INF);
+    int next = 0;
+    for (int i = 0; i < k; i++) {
+        landmarks.push_back(next);
+        from_landmark.push_back(full_dijkstra(graph, next));
+        to_landmark.push_back(full_dijkstra(reverse_graph, next));
+        next = -1;
+        for (int v = 0; v < n; v++) {
+            ll d = min(from_landmark[i][v], to_landmark[i][v]);
+            if (d < INF) closest[v] = min(closest[v], d);
+            if (closest[v] < INF && closest[v] > 0 && (next == -1 || closest[v] > closest[next]))
+                next = v;
+        }
+        if (next == -1) {
+            k = i + 1;  // nothing left to spread to
+            break;
+        }
+    }
+}
+
+bool load_landmarks(const string& path, long long sourceSize) {
+    ifstream in(path, ios::binary);
+    char magic[8];
+    int32_t kk, aa, nn;
+    int64_t size;
+    if (!in.read(magic, 8) || memcmp(magic, ALT_MAGIC, 8) != 0) return false;
+    in.read((char*)&kk, sizeof(kk));
+    in.read((char*)&aa, sizeof(aa));
+    in.read((char*)&nn, sizeof(nn));
+    in.read((char*)&size, sizeof(size));
+    if (!in || nn != n || size != sourceSize || aa != asked) return false;
+    k = kk;
+    landmarks.resize(k);
+    from_landmark.assign(k, vector<ll>(n));
+    to_landmark.assign(k, vector<ll>(n));
+    in.read((char*)landmarks.data(), k * sizeof(int));
+    for (int i = 0; i < k; i++) in.read((char*)from_landmark[i].data(), n * sizeof(ll));
+    for (int i = 0; i < k; i++) in.read((char*)to_landmark[i].data(), n * sizeof(ll));
+    return (bool)in;
+}
+
+void save_landmarks(const string& path, long long sourceSize) {
+    ofstream out(path, ios::binary | ios::trunc);
+    int32_t kk = k, aa = asked, nn = n;
+    int64_t size = sourceSize;
+    out.write(ALT_MAGIC, 8);
+    out.write((const char*)&kk, sizeof(kk));
+    out.write((const char*)&aa, sizeof(aa));
+    out.write((const char*)&nn, sizeof(nn));
+    out.write((const char*)&size, sizeof(size));
+    out.write((const char*)landmarks.data(), k * sizeof(int));
+    for (int i = 0; i < k; i++) out.write((const char*)from_landmark[i].data(), n * sizeof(ll));
+    for (int i = 0; i < k; i++) out.write((const char*)to_landmark[i].data(), n * sizeof(ll));
+}
+
+void prepare_landmarks(const string& graphPath) {
+    string path = graphPath + ".alt";
+    struct stat text;
+    stat(graphPath.c_str(), &text);
+    if (isFresh(path, text) && load_landmarks(path, text.st_size)) return;
+    pick_landmarks();
+    save_landmarks(path, text.st_size);
+}
+
+void touch(int v) {
+    if (!visited[v] && !visited_back[v] && dist[v] == INF && dist_back[v] == INF && h[v] == -1)
+        touched.push_back(v);
+}
+
+void reset() {
+    for (int v : touched) {
+        dist[v] = dist_back[v] = INF;
+        visited[v] = visited_back[v] = false;
+        h[v] = -1;
+    }
+    touched.clear();
+}
+
+// lower bound on d(v, t), remembered for the rest of the query
+ll potential(int v, int t) {
+    if (h[v] != -1) return h[v];
+    touch(v);
+    ll best = 0;
+    for (int i = 0; i < k; i++) {
+        const vector<ll>& from = from_landmark[i];
+        const vector<ll>& to = to_landmark[i];
+        if (from[t] < INF && from[v] < INF) best = max(best, from[t] - from[v]);
+        if (to[v] < INF && to[t] < INF) best = max(best, to[v] - to[t]);
+        // L reaches v but not t, or t reaches L but v doesn't: no v-t path
+        if ((from[v] < INF && from[t] == INF) || (to[t] < INF && to[v] == INF)) best = INF;
+    }
+    return h[v] = best;
+}
+
+ll alt_query(int source, int target) {
+    touch(source);
+    parent[source] = -1;
+    dist[source] = 0;
+    priority_queue<Edge, vector<Edge>, greater<Edge>> pq;
+    pq.push({source, potential(source, target)});
+    while (!pq.empty()) {
+        int from = pq.top().to;
+        pq.pop();
+        if (visited[from]) continue;
+        visited[from] = true;
+        if (from == target) break;
+        for (int i = graph.offsets[from]; i < graph.offsets[from + 1]; i++) {
+            int to = graph.targets[i];
+            if (dist[to] > dist[from] + graph.weights[i]) {
+                ll hv = potential(to, target);
+                if (hv >= INF) continue;  // t can't be reached through it
+                touch(to);
+                dist[to] = dist[from] + graph.weights[i];
+                parent[to] = from;
+                pq.push({to, dist[to] + hv});
+            }
+        }
+    }
+    return dist[target];
+}
+
+ll bidirectional_query(int source, int target) {
+    touch(source);
+    touch(target);
+    parent[source] = -1;
+    dist[source] = 0;
+    parent_back[target] = -1;
+    dist_back[target] = 0;
+    priority_queue<Edge, vector<Edge>, greater<Edge>> fq, bq;
+    fq.push({source, 0});
+    bq.push({target, 0});
+    ll best = INF;
+    int meet_from = -1, meet_to = -1;  // the s-t path crosses this edge
+    if (source == target) best = 0, meet_from = meet_to = source;
+
+    // one step of either search; the other search's labels close the gap
+    auto step = [&](const CSRGraph<ll>& g, priority_queue<Edge, vector<Edge>, greater<Edge>>& pq,
+                    vector<ll>& d, vector<int>& par, vector<bool>& vis, vector<ll>& other,
+                    bool forward) {
+        int from = pq.top().to;
+        pq.pop();
+        if (vis[from]) return;
+        vis[from] = true;
+        for (int i = g.offsets[from]; i < g.offsets[from + 1]; i++) {
+            int to = g.targets[i];
+            ll w = g.weights[i];
+            if (d[to] > d[from] + w) {
+                touch(to);
+                d[to] = d[from] + w;
+                par[to] = from;
+                pq.push({to, d[to]});
+            }
+            if (other[to] < INF && d[from] + w + other[to] < best) {
+                best = d[from] + w + other[to];
+                meet_from = forward ? from : to;
+                meet_to = forward ? to : from;
+            }
+        }
+    };
+
+    while (!fq.empty() && !bq.empty()) {
+        if (fq.top().weight + bq.top().weight >= best) break;
+        if (fq.top().weight <= bq.top().weight)
+            step(graph, fq, dist, parent, visited, dist_back, true);
+        else
+            step(reverse_graph, bq, dist_back, parent_back, visited_back, dist, false);
+    }
+    if (best == INF) return INF;
+
+    // s .. meet_from by the forward parents, meet_to .. t by the backward
+    // ones, then one parent chain along the whole path for the printing
+    // (with zero-weight edges the halves can share a vertex; the loop between
+    // the two visits costs nothing and is cut out)
+    vector<int> path;
+    unordered_map<int, int> position;
+    for (int v = meet_from; v != -1; v = parent[v]) path.push_back(v);
+    reverse(path.begin(), path.end());
+    for (int i = 0; i < (int)path.size(); i++) position[path[i]] = i;
+    if (meet_to != meet_from) {
+        for (int v = meet_to; v != -1; v = parent_back[v]) {
+            auto it = position.find(v);
+            if (it != position.end() && it->second < (int)path.size()) path.resize(it->second);
+            path.push_back(v);
+        }
+    }
+    parent[path[0]] = -1;
+    for (int i = 1; i < (int)path.size(); i++) parent[path[i]] = path[i - 1];
+    dist[target] = best;
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    string mode = argc > 1 ? argv[1] : "alt";
+    k = argc > 2 ? stoi(argv[2]) : 8;
+
+    EdgeList<ll> input;
+    if (!loadEdgeList("d_in.txt", input) || input.tail.size() < 2) {
+        cerr << "Could not read d_in.txt\n";
+        return 1;
+    }
+    n = input.n;
+    m = input.edges.size();
+    graph = buildCSR(n, input.edges);
+    for (auto& e : input.edges) swap(e.from, e.to);
+    reverse_graph = buildCSR(n, input.edges);
+    dist.assign(n + 1, INF);
+    dist_back.assign(n + 1, INF);
+    h.assign(n + 1, -1);
+    parent.resize(n + 1);
+    parent_back.resize(n + 1);
+    visited.assign(n + 1, false);
+    visited_back.assign(n + 1, false);
+
+    k = asked = max(1, min(k, n));
+    if (mode == "alt") prepare_landmarks("d_in.txt");
+
+    auto start = chrono::high_resolution_clock::now();
+    int queries = input.tail.size() / 2;
+    for (int q = 0; q < queries; q++) {
+        int s = input.tail[2 * q], d = input.tail[2 * q + 1];
+        reset();
+        ll cost = INF;
+        if (s < n && d < n) cost = mode == "alt" ? alt_query(s, d) : bidirectional_query(s, d);
+        if (cost >= INF) {
+            cout << "Destination unreachable from source\n";
+        } else {
+            cout << "Shortest path cost: " << cost << "\n";
+            stack<int> st;
+            while (d != -1) {
+                st.push(d);
+                d = parent[d];
+            }
+            while (!st.empty()) {
+                cout << st.top() << " ";
+                st.pop();
+                if (!st.empty()) cout << "-> ";
+            }
+            cout << "\n";
+        }
+    }
+    double ms = chrono::duration_cast<chrono::nanoseconds>(chrono::high_resolution_clock::now() - start)
+                    .count() /
+                1000000.0;
+    cerr << queries << " queries, " << ms / max(1, queries) << "ms per query\n";
+}